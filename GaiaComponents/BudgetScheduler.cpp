@@ -0,0 +1,109 @@
+#include "BudgetScheduler.hpp"
+
+namespace Gaia::Components
+{
+    /// Schedule a work item.
+    void BudgetScheduler::Schedule(Component* owner, WorkItem work, int priority)
+    {
+        std::unique_lock lock(LevelsMutex);
+
+        auto& level = Levels[priority];
+        auto& queue = level.Queues[owner];
+        // An owner in rotation always has a non-empty queue, the running owner is put back after its step.
+        if (queue.empty() && !(owner == RunningOwner && priority == RunningPriority))
+        {
+            level.Rotation.push_back(owner);
+        }
+        queue.push_back(std::move(work));
+    }
+
+    /// Cancel all pending work items of the given owner.
+    void BudgetScheduler::Cancel(Component* owner)
+    {
+        std::unique_lock lock(LevelsMutex);
+
+        for (auto& [priority, level] : Levels)
+        {
+            level.Queues.erase(owner);
+            for (auto finder = level.Rotation.begin(); finder != level.Rotation.end();)
+            {
+                finder = *finder == owner ? level.Rotation.erase(finder) : std::next(finder);
+            }
+        }
+        if (owner == RunningOwner)
+        {
+            RunningOwnerCancelled = true;
+        }
+    }
+
+    /// Run work items until the budget is used up or no work is pending.
+    std::size_t BudgetScheduler::RunFrame(std::chrono::steady_clock::duration budget)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + budget;
+        std::size_t step_count = 0;
+
+        std::unique_lock lock(LevelsMutex);
+        while (true)
+        {
+            auto level_finder = Levels.begin();
+            while (level_finder != Levels.end() && level_finder->second.Rotation.empty())
+            {
+                level_finder = Levels.erase(level_finder);
+            }
+            if (level_finder == Levels.end()) break;
+
+            const auto priority = level_finder->first;
+            auto& level = level_finder->second;
+            auto* owner = level.Rotation.front();
+            level.Rotation.pop_front();
+            auto& queue = level.Queues[owner];
+            auto work = std::move(queue.front());
+            queue.pop_front();
+
+            RunningOwner = owner;
+            RunningPriority = priority;
+            RunningOwnerCancelled = false;
+            lock.unlock();
+            auto status = work();
+            ++step_count;
+            lock.lock();
+            RunningOwner = nullptr;
+
+            // The level may have been erased by Cancel(), so look it up again.
+            // Cancel() has already dropped the items queued before it, the remaining ones are scheduled after it.
+            auto& current_level = Levels[priority];
+            auto& current_queue = current_level.Queues[owner];
+            if (status == WorkStatus::Pending && !RunningOwnerCancelled)
+            {
+                current_queue.push_front(std::move(work));
+            }
+            if (current_queue.empty())
+            {
+                current_level.Queues.erase(owner);
+            }
+            else
+            {
+                current_level.Rotation.push_back(owner);
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) break;
+        }
+        return step_count;
+    }
+
+    /// Get the count of pending work items.
+    std::size_t BudgetScheduler::GetPendingCount()
+    {
+        std::unique_lock lock(LevelsMutex);
+
+        std::size_t count = 0;
+        for (auto& [priority, level] : Levels)
+        {
+            for (auto& [owner, queue] : level.Queues)
+            {
+                count += queue.size();
+            }
+        }
+        return count;
+    }
+}
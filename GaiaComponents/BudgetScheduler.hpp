@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /// Result of running a step of a work item.
+    enum class WorkStatus
+    {
+        /// The work item has finished and will be removed.
+        Finished,
+        /// The work item has more steps to run, it will be continued later.
+        Pending
+    };
+
+    /**
+     * @brief BudgetScheduler time-slices incremental work items against a per-frame budget.
+     * @details Work items are run step by step. Items with higher priority run first;
+     *          items with the same priority are taken from their owner components in turn,
+     *          so one subtree with a lot of work can not starve the others.
+     *          Work which does not fit into the budget of a frame is carried over to the next frame.
+     */
+    class BudgetScheduler
+    {
+    public:
+        /// Type of work items, each invocation runs one step and reports whether the item has finished.
+        using WorkItem = std::function<WorkStatus()>;
+
+    private:
+        /// Work items of the same priority.
+        struct PriorityLevel
+        {
+            /// Owners which have pending work, in the order they will be served.
+            std::deque<Component*> Rotation;
+            /// Pending work items of every owner, in the order they were scheduled.
+            std::unordered_map<Component*, std::deque<WorkItem>> Queues;
+        };
+
+        /// Mutex for the priority levels.
+        std::mutex LevelsMutex;
+        /// Priority levels, from the highest priority to the lowest.
+        std::map<int, PriorityLevel, std::greater<>> Levels;
+        /// Owner of the work item which is running now.
+        Component* RunningOwner {nullptr};
+        /// Priority of the work item which is running now.
+        int RunningPriority {0};
+        /// Whether the work of the running owner has been cancelled while its item is running.
+        bool RunningOwnerCancelled {false};
+
+    public:
+        /**
+         * @brief Schedule a work item.
+         * @param owner The component which owns the work item, work is shared fairly between owners.
+         * @param work The work item to run step by step.
+         * @param priority Priority of the work item, higher priority work runs first.
+         * @details This function can be invoked from any thread, including from work items.
+         */
+        void Schedule(Component* owner, WorkItem work, int priority = 0);
+
+        /**
+         * @brief Cancel all pending work items of the given owner.
+         * @param owner The owner whose work items will be removed.
+         * @details Work items must be cancelled before their owner is destroyed.
+         */
+        void Cancel(Component* owner);
+
+        /**
+         * @brief Run work items until the budget is used up or no work is pending.
+         * @param budget Time budget of this frame.
+         * @return Count of steps run in this frame.
+         * @details At least one step is run if any work is pending, so work always makes progress.
+         */
+        std::size_t RunFrame(std::chrono::steady_clock::duration budget);
+
+        /// Get the count of pending work items.
+        [[nodiscard]] std::size_t GetPendingCount();
+    };
+}
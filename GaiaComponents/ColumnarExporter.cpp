@@ -0,0 +1,179 @@
+#include "ColumnarExporter.hpp"
+
+#include <fstream>
+#include <shared_mutex>
+
+namespace Gaia::Components
+{
+    namespace
+    {
+        /// Magic bytes at the beginning of an exported file.
+        constexpr char ExportMagic[8] {'G', 'A', 'I', 'A', 'C', 'O', 'L', 'S'};
+        /// Version of the exported file layout.
+        constexpr std::uint32_t ExportVersion = 1;
+
+        /// Write a trivially copyable value to the stream.
+        template <typename ValueType>
+        void WriteValue(std::ostream& stream, const ValueType& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(ValueType));
+        }
+
+        /// Write bytes to the stream and pad them to a multiple of 8 bytes.
+        void WritePadded(std::ostream& stream, const void* data, std::size_t size)
+        {
+            static constexpr char padding[8] {};
+            stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            stream.write(padding, static_cast<std::streamsize>((8 - size % 8) % 8));
+        }
+    }
+
+    /// Construct an exporter.
+    ColumnarExporter::ColumnarExporter(std::size_t batch_rows) : BatchRows(batch_rows > 0 ? batch_rows : 1)
+    {}
+
+    /// Register the schema of a type.
+    void ColumnarExporter::RegisterSchema(RecordSchema schema)
+    {
+        schema.SummaryBits = Component::GetTypeSummaryBits(schema.Hash);
+        if (auto finder = SchemaIndices.find(schema.Hash); finder != SchemaIndices.end())
+        {
+            Schemas[finder->second] = std::move(schema);
+            return;
+        }
+        SchemaIndices.emplace(schema.Hash, Schemas.size());
+        Schemas.push_back(std::move(schema));
+    }
+
+    /// Export the records of all registered types in the subtree under the given root.
+    std::size_t ColumnarExporter::Export(Component& root, const std::string& path)
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream) return 0;
+
+        stream.write(ExportMagic, sizeof(ExportMagic));
+        WriteValue(stream, ExportVersion);
+        WriteValue(stream, static_cast<std::uint32_t>(Schemas.size()));
+        for (const auto& schema : Schemas)
+        {
+            WriteValue(stream, static_cast<std::uint64_t>(schema.Hash));
+            WriteValue(stream, static_cast<std::uint32_t>(schema.Name.size()));
+            WriteValue(stream, static_cast<std::uint32_t>(schema.Columns.size()));
+            WritePadded(stream, schema.Name.data(), schema.Name.size());
+            for (const auto& column : schema.Columns)
+            {
+                WriteValue(stream, column.ElementSize);
+                WriteValue(stream, static_cast<std::uint32_t>(column.Name.size()));
+                WritePadded(stream, column.Name.data(), column.Name.size());
+            }
+        }
+
+        std::vector<RecordBatch> batches(Schemas.size());
+        for (std::size_t index = 0; index < Schemas.size(); ++index)
+        {
+            batches[index].Owners.reserve(BatchRows);
+            batches[index].Columns.resize(Schemas[index].Columns.size());
+        }
+        std::size_t record_count = 0;
+
+        auto write_rows = [this, &stream, &batches](std::size_t index, std::size_t begin, std::size_t count){
+            auto& batch = batches[index];
+            WriteValue(stream, static_cast<std::uint64_t>(Schemas[index].Hash));
+            WriteValue(stream, static_cast<std::uint64_t>(count));
+            WritePadded(stream, batch.Owners.data() + begin, count * sizeof(std::uint64_t));
+            for (std::size_t column = 0; column < batch.Columns.size(); ++column)
+            {
+                auto element_size = Schemas[index].Columns[column].ElementSize;
+                WritePadded(stream, batch.Columns[column].data() + begin * element_size, count * element_size);
+            }
+        };
+        // Write the full batches of the given schema, and the remaining rows as well if it is the last batch.
+        auto write_batches = [this, &batches, &write_rows](std::size_t index, bool last){
+            auto& batch = batches[index];
+            std::size_t written_rows = 0;
+            for (; batch.Owners.size() - written_rows >= BatchRows; written_rows += BatchRows)
+            {
+                write_rows(index, written_rows, BatchRows);
+            }
+            if (last && written_rows < batch.Owners.size())
+            {
+                write_rows(index, written_rows, batch.Owners.size() - written_rows);
+                written_rows = batch.Owners.size();
+            }
+            if (written_rows == 0) return;
+            batch.Owners.erase(batch.Owners.begin(), batch.Owners.begin() + static_cast<std::ptrdiff_t>(written_rows));
+            for (std::size_t column = 0; column < batch.Columns.size(); ++column)
+            {
+                auto& bytes = batch.Columns[column];
+                bytes.erase(bytes.begin(), bytes.begin() +
+                        static_cast<std::ptrdiff_t>(written_rows * Schemas[index].Columns[column].ElementSize));
+            }
+        };
+        auto append_record = [this, &batches, &record_count](std::size_t index, Component* owner, const void* record){
+            auto& batch = batches[index];
+            batch.Owners.push_back(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(owner)));
+            Schemas[index].Snapshot(record, batch.Columns);
+            ++record_count;
+        };
+
+        std::function<void(Component&)> visit = [this, &visit, &append_record, &batches, &write_batches](
+                Component& component){
+            bool relevant = false;
+            auto summary = component.GetSubtreeTypeSummary();
+            for (const auto& schema : Schemas)
+            {
+                relevant |= (summary & schema.SummaryBits) == schema.SummaryBits;
+            }
+            if (!relevant) return;
+
+            // Only copy the rows and collect the sub components under the lock,
+            // the writing and the recursion happen after unlocking.
+            std::vector<Component*> sub_components;
+            {
+                std::shared_lock lock(component.SubComponentsMutex);
+                for (auto& value : component.Values)
+                {
+                    auto finder = SchemaIndices.find(value.GetHash());
+                    if (finder != SchemaIndices.end() && !Schemas[finder->second].IsComponent)
+                    {
+                        append_record(finder->second, &component, value.Get());
+                    }
+                }
+                sub_components.reserve(component.SubComponents.size());
+                for (auto& [hash, sub_component] : component.SubComponents)
+                {
+                    auto finder = SchemaIndices.find(hash);
+                    if (finder != SchemaIndices.end() && Schemas[finder->second].IsComponent)
+                    {
+                        append_record(finder->second, &component, static_cast<const Component*>(sub_component.get()));
+                    }
+                    sub_components.push_back(sub_component.get());
+                }
+            }
+            for (std::size_t index = 0; index < batches.size(); ++index)
+            {
+                if (batches[index].Owners.size() >= BatchRows) write_batches(index, false);
+            }
+            for (auto* sub_component : sub_components)
+            {
+                visit(*sub_component);
+            }
+        };
+        visit(root);
+
+        for (std::size_t index = 0; index < batches.size(); ++index)
+        {
+            write_batches(index, true);
+        }
+        WriteValue(stream, std::uint64_t {0});
+        WriteValue(stream, std::uint64_t {0});
+        stream.flush();
+        return stream ? record_count : 0;
+    }
+
+    /// Get the count of registered types.
+    std::size_t ColumnarExporter::GetTypeCount() const noexcept
+    {
+        return Schemas.size();
+    }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief ColumnarExporter streams the fields of selected component and value types into a columnar file.
+     * @details Records of every registered type are gathered from a component tree into record batches of
+     *          a fixed count of rows, each batch holds an owner column and one column per registered field.
+     *          Every section of the file is aligned to 8 bytes, so the file can be memory-mapped and scanned
+     *          by downstream tools without parsing. The layout, in native byte order, is:
+     *          - File header: 8 bytes magic "GAIACOLS", uint32 version, uint32 count of schemas.
+     *          - Schema of every registered type: uint64 type ID, uint32 name length, uint32 count of columns,
+     *            the name padded to 8 bytes, then for every column: uint32 element size, uint32 name length
+     *            and the name padded to 8 bytes.
+     *          - Record batches: uint64 type ID, uint64 count of rows, the uint64 owner IDs,
+     *            then every column as a contiguous array of elements padded to 8 bytes.
+     *          - End marker: a record batch header with type ID 0 and 0 rows.
+     *          Type IDs identify schemas within a file, owner IDs identify owner components within an export.
+     */
+    class ColumnarExporter
+    {
+    public:
+        /// Default count of rows in a record batch.
+        static constexpr std::size_t DefaultBatchRows = 4096;
+
+    private:
+        /// Description of a field column.
+        struct ColumnSchema
+        {
+            /// Name of the field.
+            std::string Name;
+            /// Size of an element of the column in bytes.
+            std::uint32_t ElementSize;
+        };
+
+        /// Description of an exported type and the function to snapshot its fields.
+        struct RecordSchema
+        {
+            /// Hash code of the exported type, used as the type ID.
+            std::size_t Hash;
+            /// Bloom filter bits of the exported type in subtree type summaries.
+            std::uint64_t SummaryBits;
+            /// Whether the type is a component type, otherwise it is a value type.
+            bool IsComponent;
+            /// Name of the exported type.
+            std::string Name;
+            /// Field columns of the exported type.
+            std::vector<ColumnSchema> Columns;
+            /// Function which appends the fields of a record to the columns,
+            /// component records are passed as pointers to Component.
+            std::function<void(const void* record, std::vector<std::vector<unsigned char>>& columns)> Snapshot;
+        };
+
+        /// Rows gathered for a schema which have not been written yet.
+        struct RecordBatch
+        {
+            /// Owner ID of every row.
+            std::vector<std::uint64_t> Owners;
+            /// Field columns, in the order of the schema.
+            std::vector<std::vector<unsigned char>> Columns;
+        };
+
+        /// Count of rows in a full record batch.
+        std::size_t BatchRows;
+        /// Registered schemas, in the order of registration.
+        std::vector<RecordSchema> Schemas;
+        /// Indices of the schemas, keyed by the hash code of their types.
+        std::unordered_map<std::size_t, std::size_t> SchemaIndices;
+
+        /// Register the schema of a type, replacing the existing one of the same type.
+        void RegisterSchema(RecordSchema schema);
+
+        /// Append the bytes of a field to a column.
+        template <typename FieldType>
+        static void AppendField(std::vector<unsigned char>& column, const FieldType& field)
+        {
+            auto offset = column.size();
+            column.resize(offset + sizeof(FieldType));
+            std::memcpy(column.data() + offset, &field, sizeof(FieldType));
+        }
+
+    public:
+        /**
+         * @brief Construct an exporter.
+         * @param batch_rows Count of rows in a record batch, the last batch of a type may be shorter.
+         */
+        explicit ColumnarExporter(std::size_t batch_rows = DefaultBatchRows);
+
+        /**
+         * @brief Register a type to export with its fields.
+         * @tparam RecordType A component type, or a value type attached with Component::AddValue().
+         * @param name Name of the type written into the schema.
+         * @param field_names Names of the fields, in the same order as the fields.
+         * @param fields Pointers to the trivially copyable data members to export.
+         * @details Owner IDs of component records identify their parents,
+         *          owner IDs of value records identify the components they are attached to.
+         */
+        template <typename RecordType, typename... FieldTypes>
+        void Register(std::string name, const std::array<std::string, sizeof...(FieldTypes)>& field_names,
+                      FieldTypes RecordType::*... fields)
+        {
+            static_assert((std::is_trivially_copyable_v<FieldTypes> && ...),
+                          "Exported fields must be trivially copyable.");
+
+            RecordSchema schema;
+            schema.Hash = typeid(RecordType).hash_code();
+            schema.IsComponent = std::is_base_of_v<Component, RecordType>;
+            schema.Name = std::move(name);
+            std::uint32_t element_sizes[] {static_cast<std::uint32_t>(sizeof(FieldTypes))...};
+            for (std::size_t index = 0; index < sizeof...(FieldTypes); ++index)
+            {
+                schema.Columns.push_back({field_names[index], element_sizes[index]});
+            }
+            schema.Snapshot = [fields...](const void* record, std::vector<std::vector<unsigned char>>& columns){
+                // Component records are passed as components, so the cast is correct for any base class layout.
+                const RecordType* typed_record;
+                if constexpr (std::is_base_of_v<Component, RecordType>)
+                {
+                    typed_record = static_cast<const RecordType*>(static_cast<const Component*>(record));
+                }
+                else
+                {
+                    typed_record = static_cast<const RecordType*>(record);
+                }
+                std::size_t index = 0;
+                (AppendField(columns[index++], typed_record->*fields), ...);
+            };
+            RegisterSchema(std::move(schema));
+        }
+
+        /**
+         * @brief Export the records of all registered types in the subtree under the given root.
+         * @param root The root of the tree to export, its values are exported as well.
+         * @param path Path of the file to write, an existing file is overwritten.
+         * @return Count of the exported records, or 0 if nothing was exported.
+         * @details Records are copied under the shared locks of their owners, which only guards the sub components
+         *          and values against structural changes; fields written by other threads meanwhile may be torn.
+         *          Each lock is released before the file is written and before the sub components are visited,
+         *          so components of the tree must not be destroyed until the export has finished.
+         *          Records are written batch by batch as batches fill up, instead of after the whole tree.
+         *          Subtrees which can not contain any registered type are skipped with their type summaries.
+         */
+        std::size_t Export(Component& root, const std::string& path);
+
+        /// Get the count of registered types.
+        [[nodiscard]] std::size_t GetTypeCount() const noexcept;
+    };
+}
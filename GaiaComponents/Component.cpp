@@ -1,7 +1,73 @@
 #include "Component.hpp"
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
+
+#include "Executor.hpp"
+#include "Strand.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GAIA_COMPONENTS_PREFETCH(address, write) __builtin_prefetch((address), (write))
+#elif defined(_MSC_VER)
+#include <xmmintrin.h>
+#define GAIA_COMPONENTS_PREFETCH(address, write) \
+    _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define GAIA_COMPONENTS_PREFETCH(address, write) ((void)(address))
+#endif
+
 namespace Gaia::Components
 {
+    namespace
+    {
+        /// Observer events queued by the current thread, with the hubs to deliver them to.
+        thread_local std::vector<std::pair<std::shared_ptr<ObserverHub>, ComponentEvent>> PendingObserverEvents;
+        /// Depth of nested structural changes in the current thread.
+        thread_local std::size_t ObserverEventScopeDepth = 0;
+
+        /// Scope of a structural change, queued observer events are delivered when the outermost scope exits.
+        class ObserverEventScope
+        {
+        public:
+            ObserverEventScope() noexcept
+            {
+                ++ObserverEventScopeDepth;
+            }
+
+            ~ObserverEventScope()
+            {
+                if (--ObserverEventScopeDepth > 0 || PendingObserverEvents.empty()) return;
+
+                auto events = std::move(PendingObserverEvents);
+                PendingObserverEvents.clear();
+                // Deliver the events of each hub in one batch, observers may cause further changes.
+                ++ObserverEventScopeDepth;
+                std::vector<ComponentEvent> batch;
+                for (std::size_t index = 0; index < events.size(); ++index)
+                {
+                    auto& hub = events[index].first;
+                    if (!hub) continue;
+                    batch.clear();
+                    for (std::size_t other = index; other < events.size(); ++other)
+                    {
+                        if (events[other].first != hub) continue;
+                        batch.push_back(events[other].second);
+                        if (other != index) events[other].first.reset();
+                    }
+                    hub->Deliver(batch);
+                }
+                --ObserverEventScopeDepth;
+                if (!PendingObserverEvents.empty())
+                {
+                    ObserverEventScope nested_scope;
+                }
+            }
+        };
+    }
+
+    std::atomic<std::uint64_t> Component::ObservedTypes {0};
+
     /// Default implementation for being attached event.
     void Component::OnAttachedToComponent()
     {}
@@ -14,20 +80,40 @@ namespace Gaia::Components
     /// Default implementation for sub component detaching event.
     void Component::OnComponentDetached(Component *component)
     {}
+    /// Default implementation for asynchronous attaching event.
+    void Component::OnAttachedAsync()
+    {}
 
     /// Add a sub component_instance to this component_instance.
     Component* Component::AddSubComponent(std::size_t hash, std::unique_ptr<Component>&& component_instance)
     {
-        Component* component_pointer = component_instance.get();
+        ObserverEventScope event_scope;
+        auto lock = LockSettledSubComponent(hash);
 
-        std::unique_lock lock(SubComponentsMutex);
+        auto lazy_finder = FindLazySubComponent(hash);
+        if (lazy_finder != LazySubComponents.end())
+        {
+            LazySubComponents.erase(lazy_finder);
+        }
+
+        return InsertSubComponent(hash, std::move(component_instance));
+    }
+
+    /// Insert a sub component into the sub components map and trigger the attaching events.
+    Component* Component::InsertSubComponent(std::size_t hash, std::unique_ptr<Component>&& component_instance)
+    {
+        Component* component_pointer = component_instance.get();
 
         auto finder = SubComponents.find(hash);
         if (finder != SubComponents.end())
         {
             OnComponentDetached(finder->second.get());
             finder->second->OnDetachedFromComponent();
+            NotifyObservers(ComponentEventType::Detached, hash, finder->second.get());
+            EvictFromHotSet(hash);
+            DeactivateSubComponent(finder->second.get());
             finder->second = std::move(component_instance);
+            InvalidateSubtreeTypes();
         }
         else
         {
@@ -35,44 +121,622 @@ namespace Gaia::Components
         }
 
         component_pointer->Parent = this;
+        ActivateSubComponent(hash, component_pointer);
+        PropagateSubtreeTypes(GetTypeSummaryBits(hash) | component_pointer->GetSubtreeTypeSummary());
+        // Queue the events before the hooks, components added by the hooks are announced by their own events.
+        NotifyObservers(ComponentEventType::Attached, hash, component_pointer);
         OnComponentAttached(component_pointer);
         component_pointer->OnAttachedToComponent();
 
         return component_pointer;
     }
 
+    /// Attach staged components to their parents in one bulk step.
+    std::size_t Component::MergeStagedComponents(std::vector<StagedComponent>& staged)
+    {
+        ObserverEventScope event_scope;
+
+        std::unordered_map<Component*, std::size_t> staged_indices;
+        staged_indices.reserve(staged.size());
+        for (std::size_t index = 0; index < staged.size(); ++index)
+        {
+            staged_indices.emplace(staged[index].Pointer, index);
+        }
+
+        // Staged components replaced before being announced, they are destroyed without events.
+        std::vector<std::unique_ptr<Component>> discarded_components;
+        auto discard = [&staged, &staged_indices, &discarded_components](std::unique_ptr<Component> component){
+            std::vector<Component*> pending_components {component.get()};
+            while (!pending_components.empty())
+            {
+                auto* pending_component = pending_components.back();
+                pending_components.pop_back();
+                auto finder = staged_indices.find(pending_component);
+                if (finder != staged_indices.end()) staged[finder->second].Pointer = nullptr;
+                for (auto& [hash, sub_component] : pending_component->SubComponents)
+                {
+                    pending_components.push_back(sub_component.get());
+                }
+            }
+            discarded_components.push_back(std::move(component));
+        };
+
+        // Link components under staged parents, which are not visible to any other thread yet.
+        for (auto& entry : staged)
+        {
+            if (entry.Pointer == nullptr) continue;
+            auto parent_finder = staged_indices.find(entry.Parent);
+            if (parent_finder == staged_indices.end()) continue;
+            if (staged[parent_finder->second].Pointer == nullptr)
+            {
+                discard(std::move(entry.Instance));
+                continue;
+            }
+            auto& slot = entry.Parent->SubComponents[entry.Hash];
+            if (slot)
+            {
+                entry.Parent->DeactivateSubComponent(slot.get());
+                discard(std::move(slot));
+            }
+            slot = std::move(entry.Instance);
+            entry.Pointer->Parent = entry.Parent;
+            entry.Parent->ActivateSubComponent(entry.Hash, entry.Pointer);
+            entry.Parent->PropagateSubtreeTypes(GetTypeSummaryBits(entry.Hash) |
+                                                entry.Pointer->GetSubtreeTypeSummary());
+        }
+
+        // Group the staged components by the live parents their subtrees are merged into, in the order of staging.
+        std::vector<Component*> live_parents(staged.size(), nullptr);
+        std::vector<std::size_t> grouped_indices;
+        for (std::size_t index = 0; index < staged.size(); ++index)
+        {
+            auto& entry = staged[index];
+            if (entry.Pointer == nullptr) continue;
+            auto parent_finder = staged_indices.find(entry.Parent);
+            live_parents[index] = parent_finder == staged_indices.end() ?
+                    entry.Parent : live_parents[parent_finder->second];
+            grouped_indices.push_back(index);
+        }
+        std::stable_sort(grouped_indices.begin(), grouped_indices.end(),
+                         [&live_parents](std::size_t left, std::size_t right){
+            return std::less<Component*>()(live_parents[left], live_parents[right]);
+        });
+
+        // Staged components under staged components are announced by their own events.
+        auto staged_component = [&staged_indices](Component* component){
+            return staged_indices.find(component) != staged_indices.end();
+        };
+        // Insert the staged subtrees into the live tree, locking every live parent only once.
+        std::vector<std::pair<std::size_t, std::unique_ptr<Component>>> replaced_components;
+        std::size_t attached_count = 0;
+        for (auto group_begin = grouped_indices.begin(); group_begin != grouped_indices.end();)
+        {
+            auto* parent = live_parents[*group_begin];
+            auto group_end = std::find_if(group_begin, grouped_indices.end(), [&live_parents, parent](std::size_t index){
+                return live_parents[index] != parent;
+            });
+            // Wait for replaced components to settle, and again if one started attaching before the lock.
+            std::unique_lock<std::shared_mutex> lock;
+            while (!lock.owns_lock())
+            {
+                for (auto iterator = group_begin; iterator != group_end; ++iterator)
+                {
+                    if (staged[*iterator].Parent == parent) parent->WaitForSubComponentAttaching(staged[*iterator].Hash);
+                }
+                lock = std::unique_lock(parent->SubComponentsMutex);
+                for (auto iterator = group_begin; iterator != group_end && lock.owns_lock(); ++iterator)
+                {
+                    if (staged[*iterator].Parent != parent) continue;
+                    auto finder = parent->SubComponents.find(staged[*iterator].Hash);
+                    if (finder != parent->SubComponents.end() && !finder->second->IsSettled()) lock.unlock();
+                }
+            }
+
+            std::uint64_t bits = 0;
+            bool replaced = false;
+            auto replaced_begin = replaced_components.size();
+            for (auto iterator = group_begin; iterator != group_end; ++iterator)
+            {
+                auto& entry = staged[*iterator];
+                if (entry.Pointer == nullptr || entry.Parent != parent) continue;
+                auto lazy_finder = parent->FindLazySubComponent(entry.Hash);
+                if (lazy_finder != parent->LazySubComponents.end())
+                {
+                    parent->LazySubComponents.erase(lazy_finder);
+                }
+                auto& slot = parent->SubComponents[entry.Hash];
+                if (slot)
+                {
+                    parent->EvictFromHotSet(entry.Hash);
+                    parent->DeactivateSubComponent(slot.get());
+                    if (staged_indices.find(slot.get()) != staged_indices.end())
+                    {
+                        discard(std::move(slot));
+                    }
+                    else
+                    {
+                        replaced_components.emplace_back(entry.Hash, std::move(slot));
+                    }
+                    replaced = true;
+                }
+                slot = std::move(entry.Instance);
+                entry.Pointer->Parent = parent;
+                parent->ActivateSubComponent(entry.Hash, entry.Pointer);
+                bits |= GetTypeSummaryBits(entry.Hash) | entry.Pointer->GetSubtreeTypeSummary();
+            }
+
+            // Trigger the events before unlocking, as AddComponent() does,
+            // so the merged components can not be removed by other threads before they are announced.
+            for (auto index = replaced_begin; index < replaced_components.size(); ++index)
+            {
+                auto& [hash, component] = replaced_components[index];
+                parent->OnComponentDetached(component.get());
+                component->OnDetachedFromComponent();
+                parent->NotifyObservers(ComponentEventType::Detached, hash, component.get());
+            }
+            // Queue the events before the hooks, components added by the hooks are announced by their own events.
+            for (auto iterator = group_begin; iterator != group_end; ++iterator)
+            {
+                auto& entry = staged[*iterator];
+                if (entry.Pointer == nullptr) continue;
+                entry.Parent->NotifyObservers(ComponentEventType::Attached, entry.Hash, entry.Pointer,
+                                              staged_component);
+            }
+            for (auto iterator = group_begin; iterator != group_end; ++iterator)
+            {
+                auto& entry = staged[*iterator];
+                if (entry.Pointer == nullptr) continue;
+                entry.Parent->OnComponentAttached(entry.Pointer);
+                entry.Pointer->OnAttachedToComponent();
+                ++attached_count;
+            }
+            lock.unlock();
+            if (replaced) parent->InvalidateSubtreeTypes();
+            parent->PropagateSubtreeTypes(bits);
+            group_begin = group_end;
+        }
+        staged.clear();
+        return attached_count;
+    }
+
+    /// Find the factory of the lazy sub component with the given hash code.
+    decltype(Component::LazySubComponents)::iterator Component::FindLazySubComponent(std::size_t hash)
+    {
+        return std::find_if(LazySubComponents.begin(), LazySubComponents.end(), [hash](const auto& factory){
+            return factory.first == hash;
+        });
+    }
+
+    /// Register the factory of a sub component, which will be invoked when it is first accessed.
+    void Component::RegisterLazySubComponent(std::size_t hash, std::function<std::unique_ptr<Component>()> factory)
+    {
+        ObserverEventScope event_scope;
+        auto lock = LockSettledSubComponent(hash);
+
+        auto finder = SubComponents.find(hash);
+        if (finder != SubComponents.end())
+        {
+            finder->second->OnDetachedFromComponent();
+            OnComponentDetached(finder->second.get());
+            NotifyObservers(ComponentEventType::Detached, hash, finder->second.get());
+            EvictFromHotSet(hash);
+            DeactivateSubComponent(finder->second.get());
+            SubComponents.erase(finder);
+            InvalidateSubtreeTypes();
+        }
+
+        auto lazy_finder = FindLazySubComponent(hash);
+        if (lazy_finder != LazySubComponents.end())
+        {
+            lazy_finder->second = std::move(factory);
+        }
+        else
+        {
+            LazySubComponents.emplace_back(hash, std::move(factory));
+        }
+        PropagateSubtreeTypes(GetTypeSummaryBits(hash));
+    }
+
+    /// Construct the lazy sub component with the given hash code and insert it.
+    Component* Component::ConstructLazySubComponent(std::size_t hash)
+    {
+        ObserverEventScope event_scope;
+        std::unique_lock lock(SubComponentsMutex);
+
+        // Another thread may have constructed it before this thread acquired the lock.
+        auto finder = SubComponents.find(hash);
+        if (finder != SubComponents.end())
+        {
+            return finder->second.get();
+        }
+        auto lazy_finder = FindLazySubComponent(hash);
+        if (lazy_finder == LazySubComponents.end())
+        {
+            return nullptr;
+        }
+        // Keep the factory registered if it throws.
+        auto component = lazy_finder->second();
+        LazySubComponents.erase(lazy_finder);
+        return InsertSubComponent(hash, std::move(component));
+    }
+
+    /// Check whether a sub component with the given hash code exists or is registered.
+    bool Component::HasSubComponent(std::size_t hash)
+    {
+        std::shared_lock lock(SubComponentsMutex);
+        return SubComponents.find(hash) != SubComponents.end() ||
+               FindLazySubComponent(hash) != LazySubComponents.end();
+    }
+
     /// Remove the sub component with the demanded hash code.
     void Component::RemoveSubComponent(std::size_t hash)
     {
-        std::unique_lock lock(SubComponentsMutex);
+        ObserverEventScope event_scope;
+        auto lock = LockSettledSubComponent(hash);
 
         auto finder = SubComponents.find(hash);
         if (finder != SubComponents.end())
         {
             finder->second->OnDetachedFromComponent();
             OnComponentDetached(finder->second.get());
+            NotifyObservers(ComponentEventType::Detached, hash, finder->second.get());
+            EvictFromHotSet(hash);
+            DeactivateSubComponent(finder->second.get());
             SubComponents.erase(finder);
+            InvalidateSubtreeTypes();
+        }
+
+        auto lazy_finder = FindLazySubComponent(hash);
+        if (lazy_finder != LazySubComponents.end())
+        {
+            LazySubComponents.erase(lazy_finder);
+            InvalidateSubtreeTypes();
         }
     }
 
     /// Get the sub component with the demanded hash code.
     Component* Component::GetSubComponent(std::size_t hash)
     {
-        std::shared_lock lock(SubComponentsMutex);
+        Component* found_component = nullptr;
+        {
+            std::shared_lock lock(SubComponentsMutex);
 
-        auto finder = SubComponents.find(hash);
-        if (finder != SubComponents.end())
+            if (HotSet != nullptr)
+            {
+                for (auto& [hot_hash, hot_component] : HotSet->Entries)
+                {
+                    if (hot_component != nullptr && hot_hash == hash)
+                    {
+                        // Hits are sampled per thread, so that hot components are not written by every lookup.
+                        thread_local std::uint32_t hit_count = 0;
+                        if ((++hit_count & (HotSetHitSamplePeriod - 1)) == 0)
+                        {
+                            hot_component->AccessCount.fetch_add(HotSetHitSamplePeriod, std::memory_order_relaxed);
+                        }
+                        return hot_component;
+                    }
+                }
+            }
+
+            auto finder = SubComponents.find(hash);
+            if (finder != SubComponents.end())
+            {
+                if (SubComponents.size() < HotSetThreshold)
+                {
+                    return finder->second.get();
+                }
+                finder->second->AccessCount.fetch_add(1, std::memory_order_relaxed);
+                // The first miss of a large enough component allocates the hot set.
+                bool rebuilding = HotSet == nullptr ||
+                        HotSet->MissCount.fetch_add(1, std::memory_order_relaxed) % HotSetRebuildPeriod ==
+                        HotSetRebuildPeriod - 1;
+                if (!rebuilding)
+                {
+                    return finder->second.get();
+                }
+                found_component = finder->second.get();
+            }
+            else if (LazySubComponents.empty() || FindLazySubComponent(hash) == LazySubComponents.end())
+            {
+                return nullptr;
+            }
+        }
+        if (found_component == nullptr)
         {
-            return finder->second.get();
+            return ConstructLazySubComponent(hash);
+        }
+        // Skip rebuilding if other threads are holding the lock, the next period will retry.
+        std::unique_lock lock(SubComponentsMutex, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            RebuildHotSet();
+        }
+        return found_component;
+    }
+
+    /// Get the sub components with the demanded hash code from many parents.
+    void Component::GetSubComponentBatch(std::size_t hash, Component* const* parents, std::size_t count,
+                                         Component** results)
+    {
+        constexpr std::size_t prefetch_distance = 8;
+
+        auto prefetch = [parents](std::size_t index){
+            auto* parent = parents[index];
+            // The mutex is written by the shared lock, the hot set and the map are only read.
+            GAIA_COMPONENTS_PREFETCH(&parent->SubComponentsMutex, 1);
+            GAIA_COMPONENTS_PREFETCH(&parent->SubComponents, 0);
+            GAIA_COMPONENTS_PREFETCH(&parent->HotSet, 0);
+        };
+
+        for (std::size_t index = 0; index < std::min(prefetch_distance, count); ++index)
+        {
+            prefetch(index);
+        }
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            if (index + prefetch_distance < count)
+            {
+                prefetch(index + prefetch_distance);
+            }
+            results[index] = parents[index]->GetSubComponent(hash);
+        }
+    }
+
+    /// Rebuild the hot set with the most frequently accessed sub components.
+    void Component::RebuildHotSet()
+    {
+        if (HotSet == nullptr)
+        {
+            HotSet = std::make_unique<HotSetState>();
+        }
+        auto& entries = HotSet->Entries;
+        entries.fill({0, nullptr});
+        std::array<std::uint32_t, HotSetSize> hot_access_counts {};
+
+        for (auto& [hash, component] : SubComponents)
+        {
+            auto access_count = component->AccessCount.load(std::memory_order_relaxed);
+            // Halve the counts, so that the hot set follows the recent access pattern.
+            component->AccessCount.store(access_count / 2, std::memory_order_relaxed);
+            if (access_count == 0) continue;
+
+            // Keep the hot set in descending order of access counts.
+            std::pair<std::size_t, Component*> entry {hash, component.get()};
+            for (std::size_t index = 0; index < HotSetSize; ++index)
+            {
+                if (entries[index].second == nullptr || hot_access_counts[index] < access_count)
+                {
+                    std::swap(entries[index], entry);
+                    std::swap(hot_access_counts[index], access_count);
+                    if (entry.second == nullptr) break;
+                }
+            }
+        }
+    }
+
+    /// Remove the sub component with the given hash code from the hot set.
+    void Component::EvictFromHotSet(std::size_t hash) noexcept
+    {
+        if (HotSet == nullptr) return;
+        for (auto& [hot_hash, hot_component] : HotSet->Entries)
+        {
+            if (hot_component != nullptr && hot_hash == hash)
+            {
+                hot_component = nullptr;
+            }
+        }
+    }
+
+    /// Move the sub components and the state of another component into this new component.
+    Component::Component(Component&& other) noexcept
+    {
+        std::unique_lock lock(other.SubComponentsMutex);
+        TakeSubComponents(other);
+        // The new component takes the place of the other one, such as when it is relocated.
+        Asleep.store(other.Asleep.load());
+        AccessCount.store(other.AccessCount.load());
+        State.store(other.State.load());
+        AttachingTask = other.AttachingTask;
+    }
+
+    /// Replace the sub components and the state of this component with those of another component.
+    Component& Component::operator=(Component&& other)
+    {
+        if (&other == this) return *this;
+
+        decltype(SubComponents) previous_components;
+        decltype(Values) previous_values;
+        auto all_settled = [](const decltype(SubComponents)& components){
+            return std::all_of(components.begin(), components.end(), [](const auto& entry){
+                return entry.second->IsSettled();
+            });
+        };
+        while (true)
+        {
+            // Wait without holding the locks, OnAttachedAsync() of the sub components may access their parents.
+            WaitForSubComponentsAttaching();
+            other.WaitForSubComponentsAttaching();
+            std::unique_lock lock(SubComponentsMutex, std::defer_lock);
+            std::unique_lock other_lock(other.SubComponentsMutex, std::defer_lock);
+            std::lock(lock, other_lock);
+            // Another thread may have added attaching components between the waiting and the locking.
+            if (!all_settled(SubComponents) || !all_settled(other.SubComponents)) continue;
+
+            previous_components = std::move(SubComponents);
+            SubComponents.clear();
+            LazySubComponents.clear();
+            for (auto& [hash, component] : previous_components)
+            {
+                component->ActiveIndex = InactiveIndex;
+            }
+            ActiveSubComponents.clear();
+            previous_values = std::move(Values);
+            TakeSubComponents(other);
+            break;
+        }
+        // Invoke the hooks without holding the locks, they may access this component.
+        for (auto& [hash, component] : previous_components)
+        {
+            component->OnDetachedFromComponent();
+        }
+        // The types of the subtree have changed, update the summaries of the ancestors.
+        if (Parent != nullptr)
+        {
+            Parent->InvalidateSubtreeTypes();
+        }
+        return *this;
+    }
+
+    /// Attach a value, replacing the existing value of the same type.
+    void* Component::InsertValue(ComponentValue value)
+    {
+        auto hash = value.GetHash();
+        void* address;
+        {
+            std::unique_lock lock(SubComponentsMutex);
+            auto finder = std::find_if(Values.begin(), Values.end(), [hash](const ComponentValue& entry){
+                return entry.GetHash() == hash;
+            });
+            if (finder != Values.end())
+            {
+                // Swap so the replaced value is destroyed after the lock is released.
+                std::swap(*finder, value);
+                address = finder->Get();
+            }
+            else
+            {
+                address = Values.emplace_back(std::move(value)).Get();
+            }
+        }
+        PropagateSubtreeTypes(GetTypeSummaryBits(hash));
+        return address;
+    }
+
+    /// Get the address of the value with the given type hash code.
+    void* Component::FindValue(std::size_t hash)
+    {
+        std::shared_lock lock(SubComponentsMutex);
+        for (auto& value : Values)
+        {
+            if (value.GetHash() == hash) return value.Get();
         }
         return nullptr;
     }
 
+    /// Remove the value with the given type hash code.
+    bool Component::EraseValue(std::size_t hash)
+    {
+        std::optional<ComponentValue> removed_value;
+        {
+            std::unique_lock lock(SubComponentsMutex);
+            auto finder = std::find_if(Values.begin(), Values.end(), [hash](const ComponentValue& entry){
+                return entry.GetHash() == hash;
+            });
+            if (finder == Values.end()) return false;
+            removed_value.emplace(std::move(*finder));
+            if (finder != std::prev(Values.end()))
+            {
+                *finder = std::move(Values.back());
+            }
+            Values.pop_back();
+        }
+        InvalidateSubtreeTypes();
+        return true;
+    }
+
+    /// Take the sub components and the subtree state of another component.
+    void Component::TakeSubComponents(Component& other)
+    {
+        SubComponents = std::move(other.SubComponents);
+        other.SubComponents.clear();
+        LazySubComponents = std::move(other.LazySubComponents);
+        other.LazySubComponents.clear();
+        Values = std::move(other.Values);
+        other.Values.clear();
+        for (auto& [hash, component] : SubComponents)
+        {
+            component->Parent = this;
+        }
+        ActiveSubComponents = std::move(other.ActiveSubComponents);
+        other.ActiveSubComponents.clear();
+
+        HotSet = std::move(other.HotSet);
+        SubtreeTypeSummary.store(other.SubtreeTypeSummary.exchange(0));
+        SubtreeTypeSummaryStale.store(other.SubtreeTypeSummaryStale.exchange(false));
+        // Both subtrees have changed, so both versions must move forward to outdate the caches.
+        SubtreeVersion.store(std::max(SubtreeVersion.load(), other.SubtreeVersion.load()) + 1);
+        other.InvalidateSubtreeTypes();
+
+        std::atomic_store(&BoundStrand, std::atomic_exchange(&other.BoundStrand, std::shared_ptr<Strand>()));
+        std::atomic_store(&Observers, std::atomic_exchange(&other.Observers, std::shared_ptr<ObserverHub>()));
+    }
+
+    /// Move an attached component to another address and fix up its parent.
+    bool Component::RelocateSubComponent(Component* component, const std::function<Component*()>& move_construct)
+    {
+        auto* parent = component->Parent;
+        if (parent == nullptr || !component->IsSettled()) return false;
+
+        std::unique_lock lock(parent->SubComponentsMutex);
+
+        auto finder = parent->SubComponents.find(component->ParentHash);
+        if (finder == parent->SubComponents.end() || finder->second.get() != component) return false;
+
+        auto* relocated_component = move_construct();
+        // The old instance is destroyed by the caller, it must not be deleted by the unique pointer.
+        (void)finder->second.release();
+        finder->second.reset(relocated_component);
+        relocated_component->Parent = parent;
+        relocated_component->ParentHash = component->ParentHash;
+        relocated_component->ActiveIndex = component->ActiveIndex;
+        if (component->ActiveIndex != InactiveIndex)
+        {
+            parent->ActiveSubComponents[component->ActiveIndex].second = relocated_component;
+        }
+        if (parent->HotSet != nullptr)
+        {
+            for (auto& [hot_hash, hot_component] : parent->HotSet->Entries)
+            {
+                if (hot_component == component) hot_component = relocated_component;
+            }
+        }
+        // Handles follow the anchor to the new instance, and the old instance will not clear it when destroyed.
+        if (auto anchor = std::atomic_exchange(&component->Anchor, std::shared_ptr<std::atomic<Component*>>()))
+        {
+            anchor->store(relocated_component, std::memory_order_release);
+            std::atomic_store(&relocated_component->Anchor, std::move(anchor));
+        }
+        // Increase the versions without new types, so that cached pointers to the old instance are resolved again.
+        parent->PropagateSubtreeTypes(0);
+        return true;
+    }
+
+    /// Get the anchor of this component, creating it if it does not exist yet.
+    std::shared_ptr<const std::atomic<Component*>> Component::GetAnchor()
+    {
+        auto anchor = std::atomic_load(&Anchor);
+        if (anchor == nullptr)
+        {
+            auto created_anchor = std::make_shared<std::atomic<Component*>>(this);
+            // Another thread may have created the anchor meanwhile, then its anchor is loaded instead.
+            if (std::atomic_compare_exchange_strong(&Anchor, &anchor, created_anchor))
+            {
+                anchor = std::move(created_anchor);
+            }
+        }
+        return anchor;
+    }
+
     /// Destructor which will invoke OnDetachedFromComponent() for all existing sub components.
     Component::~Component()
     {
+        if (auto anchor = std::atomic_load(&Anchor))
+        {
+            anchor->store(nullptr, std::memory_order_release);
+        }
         for (auto& component : SubComponents)
         {
+            component.second->WaitUntilSettled();
             component.second->OnDetachedFromComponent();
         }
     }
@@ -80,15 +744,406 @@ namespace Gaia::Components
     /// Separate a sub component.
     std::unique_ptr<Component> Component::SeparateSubComponent(std::size_t hash)
     {
-        std::shared_lock lock(SubComponentsMutex);
+        ObserverEventScope event_scope;
+        auto lock = LockSettledSubComponent(hash);
 
         auto finder = SubComponents.find(hash);
         if (finder != SubComponents.end())
         {
             auto component = std::move(finder->second);
             SubComponents.erase(finder);
+            EvictFromHotSet(hash);
+            DeactivateSubComponent(component.get());
+            NotifyObservers(ComponentEventType::Detached, hash, component.get());
+            component->Parent = nullptr;
+            InvalidateSubtreeTypes();
+            return component;
+        }
+
+        // A lazy component is constructed directly as an individual component.
+        auto lazy_finder = FindLazySubComponent(hash);
+        if (lazy_finder != LazySubComponents.end())
+        {
+            auto component = lazy_finder->second();
+            LazySubComponents.erase(lazy_finder);
+            InvalidateSubtreeTypes();
             return component;
         }
         return std::unique_ptr<Component>();
     }
+
+    /// Get the bits in the subtree type summary which represent the given type hash code.
+    std::uint64_t Component::GetTypeSummaryBits(std::size_t hash) noexcept
+    {
+        // Two bits per type, taken from different parts of the hash code, to lower the false positive rate.
+        return (std::uint64_t(1) << (hash & 63u)) | (std::uint64_t(1) << ((hash >> 6u) & 63u));
+    }
+
+    /// Merge the given summary bits into this component and all its ancestors.
+    void Component::PropagateSubtreeTypes(std::uint64_t bits)
+    {
+        for (auto* component = this; component != nullptr; component = component->Parent)
+        {
+            component->SubtreeVersion.fetch_add(1);
+            component->SubtreeTypeSummary.fetch_or(bits);
+        }
+    }
+
+    /// Mark the summaries of this component and all its ancestors as stale.
+    void Component::InvalidateSubtreeTypes()
+    {
+        for (auto* component = this; component != nullptr; component = component->Parent)
+        {
+            component->SubtreeVersion.fetch_add(1);
+            component->SubtreeTypeSummaryStale.store(true);
+        }
+    }
+
+    /// Get the type summary of the subtree under this component.
+    std::uint64_t Component::GetSubtreeTypeSummary()
+    {
+        if (!SubtreeTypeSummaryStale.exchange(false))
+        {
+            return SubtreeTypeSummary.load();
+        }
+
+        auto version = SubtreeVersion.load();
+        std::uint64_t summary = 0;
+        {
+            std::shared_lock lock(SubComponentsMutex);
+            for (auto& [hash, component] : SubComponents)
+            {
+                summary |= GetTypeSummaryBits(hash) | component->GetSubtreeTypeSummary();
+            }
+            for (auto& [hash, factory] : LazySubComponents)
+            {
+                summary |= GetTypeSummaryBits(hash);
+            }
+            for (auto& value : Values)
+            {
+                summary |= GetTypeSummaryBits(value.GetHash());
+            }
+        }
+        auto previous_summary = SubtreeTypeSummary.exchange(summary);
+        // The subtree has been modified during recomputing, keep the old bits to avoid false negatives.
+        if (SubtreeVersion.load() != version)
+        {
+            SubtreeTypeSummary.fetch_or(previous_summary);
+            SubtreeTypeSummaryStale.store(true);
+            return summary | previous_summary;
+        }
+        return summary;
+    }
+
+    /// Invoke the visitor on every constructed sub component while holding the read lock.
+    void Component::ForEachComponent(const std::function<void(Component*)>& visitor)
+    {
+        std::shared_lock lock(SubComponentsMutex);
+        for (auto& [hash, component] : SubComponents)
+        {
+            visitor(component.get());
+        }
+    }
+
+    /// Invoke the visitor on every sub component which is awake while holding the read lock.
+    void Component::ForEachActiveComponent(const std::function<void(Component*)>& visitor)
+    {
+        std::shared_lock lock(SubComponentsMutex);
+        for (auto& [hash, component] : ActiveSubComponents)
+        {
+            visitor(component);
+        }
+    }
+
+    /// Record the hash code of a newly inserted sub component and add it to the active ones if awake.
+    void Component::ActivateSubComponent(std::size_t hash, Component* component) noexcept
+    {
+        component->ParentHash = hash;
+        if (component->Asleep.load() || component->ActiveIndex != InactiveIndex) return;
+        component->ActiveIndex = ActiveSubComponents.size();
+        ActiveSubComponents.emplace_back(hash, component);
+    }
+
+    /// Remove a sub component from the active ones by swapping it with the last one.
+    void Component::DeactivateSubComponent(Component* component) noexcept
+    {
+        auto index = component->ActiveIndex;
+        if (index == InactiveIndex) return;
+        if (index != ActiveSubComponents.size() - 1)
+        {
+            ActiveSubComponents[index] = ActiveSubComponents.back();
+            ActiveSubComponents[index].second->ActiveIndex = index;
+        }
+        ActiveSubComponents.pop_back();
+        component->ActiveIndex = InactiveIndex;
+    }
+
+    /// Put this component to sleep or wake it up.
+    void Component::SetAsleep(bool asleep)
+    {
+        auto* parent = Parent;
+        if (parent == nullptr)
+        {
+            Asleep.store(asleep);
+            return;
+        }
+        // Change the state under the lock of the parent, so concurrent sleeping and waking can not interleave.
+        std::unique_lock lock(parent->SubComponentsMutex);
+        Asleep.store(asleep);
+        if (asleep)
+        {
+            parent->DeactivateSubComponent(this);
+        }
+        else
+        {
+            parent->ActivateSubComponent(ParentHash, this);
+        }
+    }
+
+    /// Put this component and its subtree to sleep.
+    void Component::Sleep()
+    {
+        SetAsleep(true);
+    }
+
+    /// Wake this component up.
+    void Component::Wake()
+    {
+        SetAsleep(false);
+    }
+
+    /// Check whether this component is asleep.
+    bool Component::IsAsleep() const noexcept
+    {
+        return Asleep.load();
+    }
+
+    /// Check whether neither this component nor any of its ancestors is asleep.
+    bool Component::IsAwakeInTree() const noexcept
+    {
+        for (auto* component = this; component != nullptr; component = component->Parent)
+        {
+            if (component->Asleep.load()) return false;
+        }
+        return true;
+    }
+
+    /// Visit all components with the given type hash code in the subtree under this component.
+    void Component::VisitSubtree(std::size_t hash, const std::function<void(Component*)>& visitor)
+    {
+        auto bits = GetTypeSummaryBits(hash);
+        if ((GetSubtreeTypeSummary() & bits) != bits) return;
+
+        std::shared_lock lock(SubComponentsMutex);
+        for (auto& [component_hash, component] : ActiveSubComponents)
+        {
+            if (component_hash == hash)
+            {
+                visitor(component);
+            }
+            component->VisitSubtree(hash, visitor);
+        }
+    }
+
+    /// Bind the subtree under this component to the given strand.
+    void Component::BindStrand(std::shared_ptr<Strand> strand)
+    {
+        std::atomic_store(&BoundStrand, std::move(strand));
+    }
+
+    /// Get the strand which this component is bound to.
+    std::shared_ptr<Strand> Component::GetStrand() const
+    {
+        for (const auto* component = this; component != nullptr; component = component->Parent)
+        {
+            auto strand = std::atomic_load(&component->BoundStrand);
+            if (strand) return strand;
+        }
+        return nullptr;
+    }
+
+    /// Post a message to the strand which this component is bound to.
+    bool Component::Post(std::function<void()> message)
+    {
+        auto strand = GetStrand();
+        if (!strand) return false;
+        strand->Post(std::move(message));
+        return true;
+    }
+
+    /// Add a sub component and run its asynchronous attaching on the given executor.
+    Component* Component::AddSubComponentAsync(Executor& executor, std::size_t hash,
+                                               std::unique_ptr<Component>&& component,
+                                               std::function<void(Component*, std::exception_ptr)> on_settled)
+    {
+        auto attaching_promise = std::make_shared<std::promise<void>>();
+        component->State.store(ComponentState::Attaching);
+        component->AttachingTask = attaching_promise->get_future().share();
+
+        auto* component_pointer = AddSubComponent(hash, std::move(component));
+
+        executor.Post([component_pointer, attaching_promise, on_settled = std::move(on_settled)]{
+            std::exception_ptr exception;
+            try
+            {
+                component_pointer->OnAttachedAsync();
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+            component_pointer->State.store(exception ? ComponentState::Failed : ComponentState::Ready);
+            // Continue before settling, the component can not be removed or relocated until the continuation returns.
+            on_settled(component_pointer, exception);
+            attaching_promise->set_value();
+        });
+
+        return component_pointer;
+    }
+
+    /// Wait until the asynchronous attaching of this component settles.
+    void Component::WaitUntilSettled() const
+    {
+        // Wait for the future rather than checking the state, the state is set before the attaching settles.
+        if (AttachingTask.valid())
+        {
+            AttachingTask.wait();
+        }
+    }
+
+    /// Check whether the asynchronous attaching of this component has settled.
+    bool Component::IsSettled() const
+    {
+        return !AttachingTask.valid() ||
+               AttachingTask.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /// Exclusively lock the sub components once the sub component with the given hash code is not attaching.
+    std::unique_lock<std::shared_mutex> Component::LockSettledSubComponent(std::size_t hash)
+    {
+        while (true)
+        {
+            WaitForSubComponentAttaching(hash);
+            std::unique_lock lock(SubComponentsMutex);
+            // Another thread may have added an attaching component between the waiting and the locking.
+            auto finder = SubComponents.find(hash);
+            if (finder == SubComponents.end() || finder->second->IsSettled()) return lock;
+        }
+    }
+
+    /// Wait for the asynchronous attaching of all sub components to settle.
+    void Component::WaitForSubComponentsAttaching()
+    {
+        std::vector<std::shared_future<void>> attaching_tasks;
+        {
+            std::shared_lock lock(SubComponentsMutex);
+            for (auto& [hash, component] : SubComponents)
+            {
+                if (!component->IsSettled()) attaching_tasks.push_back(component->AttachingTask);
+            }
+        }
+        // Wait on copies of the futures, the components may be removed by other threads meanwhile.
+        for (auto& task : attaching_tasks)
+        {
+            task.wait();
+        }
+    }
+
+    /// Wait for the asynchronous attaching of the sub component with the given hash code to settle.
+    void Component::WaitForSubComponentAttaching(std::size_t hash)
+    {
+        Component* component = nullptr;
+        {
+            std::shared_lock lock(SubComponentsMutex);
+            auto finder = SubComponents.find(hash);
+            if (finder != SubComponents.end()) component = finder->second.get();
+        }
+        // Wait without holding the lock, OnAttachedAsync() may access this component.
+        if (component != nullptr)
+        {
+            component->WaitUntilSettled();
+        }
+    }
+
+    /// Queue an event for the observers of this component and its ancestors.
+    void Component::NotifyObservers(ComponentEventType type, std::size_t hash, Component* component,
+                                    const std::function<bool(Component*)>& announced)
+    {
+        auto observed_types = ObservedTypes.load(std::memory_order_relaxed);
+        if (observed_types == 0) return;
+
+        auto bits = GetTypeSummaryBits(hash);
+        if ((observed_types & bits) == bits)
+        {
+            QueueObserverEvent({type, hash, this, component});
+        }
+        // Components nested in the subtree are attached or detached together with it.
+        if ((component->GetSubtreeTypeSummary() & observed_types) != 0)
+        {
+            QueueNestedObserverEvents(type, component, announced);
+        }
+    }
+
+    /// Queue an event for the observers of this component and its ancestors which are interested in its type.
+    void Component::QueueObserverEvent(const ComponentEvent& event)
+    {
+        for (auto* ancestor = this; ancestor != nullptr; ancestor = ancestor->Parent)
+        {
+            auto hub = std::atomic_load(&ancestor->Observers);
+            if (hub && hub->IsObserving(event.TypeHash))
+            {
+                PendingObserverEvents.emplace_back(std::move(hub), event);
+            }
+        }
+    }
+
+    /// Queue events for the observers of this component and its ancestors about the components under a subtree.
+    void Component::QueueNestedObserverEvents(ComponentEventType type, Component* component,
+                                              const std::function<bool(Component*)>& announced)
+    {
+        auto observed_types = ObservedTypes.load(std::memory_order_relaxed);
+        std::shared_lock lock(component->SubComponentsMutex);
+        for (auto& [hash, sub_component] : component->SubComponents)
+        {
+            if (announced && announced(sub_component.get())) continue;
+            auto bits = GetTypeSummaryBits(hash);
+            if ((observed_types & bits) == bits)
+            {
+                QueueObserverEvent({type, hash, component, sub_component.get()});
+            }
+            if ((sub_component->GetSubtreeTypeSummary() & observed_types) != 0)
+            {
+                QueueNestedObserverEvents(type, sub_component.get(), announced);
+            }
+        }
+    }
+
+    /// Subscribe to the structural change events of a component type in the subtree.
+    std::size_t Component::ObserveSubComponents(std::size_t hash, ComponentObserverCallback callback,
+                                                Executor* executor)
+    {
+        auto hub = std::atomic_load(&Observers);
+        if (!hub)
+        {
+            std::unique_lock lock(SubComponentsMutex);
+            hub = std::atomic_load(&Observers);
+            if (!hub)
+            {
+                hub = std::make_shared<ObserverHub>();
+                std::atomic_store(&Observers, hub);
+            }
+        }
+        auto identifier = hub->Subscribe(hash, std::move(callback), executor);
+        ObservedTypes.fetch_or(GetTypeSummaryBits(hash));
+        return identifier;
+    }
+
+    /// Cancel an observer subscription.
+    void Component::Unobserve(std::size_t identifier)
+    {
+        if (auto hub = std::atomic_load(&Observers))
+        {
+            hub->Unsubscribe(identifier);
+        }
+    }
 }
\ No newline at end of file
@@ -1,13 +1,50 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <shared_mutex>
 #include <typeindex>
 #include <type_traits>
 
+#include "ComponentObserver.hpp"
+#include "ComponentValue.hpp"
+
 namespace Gaia::Components
 {
+    class Executor;
+    class Strand;
+    template <typename ComponentType>
+    class Sibling;
+    template <typename ComponentType>
+    class PooledComponent;
+    class UpdateDispatcher;
+    class TieredUpdateScheduler;
+    class TreeBuilder;
+    class ColumnarExporter;
+    template <typename ComponentType>
+    class ComponentHandle;
+
+    /// Readiness state of a component.
+    enum class ComponentState
+    {
+        /// The component is ready to use.
+        Ready,
+        /// The asynchronous attaching of the component is still running.
+        Attaching,
+        /// The asynchronous attaching of the component has thrown an exception.
+        Failed
+    };
+
     /**
      * @brief Component is both the declaration of the support to a specular kind of functions,
      *        and the interface to access those functions.
@@ -18,11 +55,125 @@ namespace Gaia::Components
      */
     class Component
     {
+        template <typename ComponentType>
+        friend class Sibling;
+        template <typename ComponentType>
+        friend class PooledComponent;
+        friend class UpdateDispatcher;
+        friend class TieredUpdateScheduler;
+        friend class TreeBuilder;
+        friend class ColumnarExporter;
+        template <typename ComponentType>
+        friend class ComponentHandle;
+
     private:
         /// Mutex for sub components map.
         std::shared_mutex SubComponentsMutex;
         /// Map type hash code to sub component instance.
         std::unordered_map<std::size_t, std::unique_ptr<Component>> SubComponents;
+        /// Factories of the registered sub components which have not been constructed yet.
+        std::vector<std::pair<std::size_t, std::function<std::unique_ptr<Component>()>>> LazySubComponents;
+        /// Plain values attached to this component, guarded by the sub components mutex.
+        std::vector<ComponentValue> Values;
+
+        /// Active index of components which are not in the active sub components of a parent.
+        static constexpr std::size_t InactiveIndex = std::numeric_limits<std::size_t>::max();
+        /// Sub components which are awake with their hash codes, in no particular order.
+        std::vector<std::pair<std::size_t, Component*>> ActiveSubComponents;
+        /// Index of this component in the active sub components of its parent, or InactiveIndex.
+        std::size_t ActiveIndex {InactiveIndex};
+        /// Hash code which this component is attached to its parent with.
+        std::size_t ParentHash {0};
+        /// Whether this component and its subtree are asleep.
+        std::atomic<bool> Asleep {false};
+
+        /// Count of entries in the hot set.
+        static constexpr std::size_t HotSetSize = 4;
+        /// Minimum count of sub components to start tracking accesses and maintaining the hot set.
+        static constexpr std::size_t HotSetThreshold = 8;
+        /// Count of lookups missing the hot set between two rebuildings of the hot set.
+        static constexpr std::uint32_t HotSetRebuildPeriod = 256;
+        /// Only one of this many hits on the hot set is counted per thread, it must be a power of two.
+        static constexpr std::uint32_t HotSetHitSamplePeriod = 16;
+        /// The hot set of a component with many sub components.
+        struct HotSetState
+        {
+            /// The most frequently accessed sub components, which are probed before the sub components map.
+            std::array<std::pair<std::size_t, Component*>, HotSetSize> Entries {};
+            /// Count of lookups which missed the hot set.
+            std::atomic<std::uint32_t> MissCount {0};
+        };
+        /// The hot set, it is only allocated once the count of sub components reaches HotSetThreshold.
+        std::unique_ptr<HotSetState> HotSet;
+        /// Count of recent accesses to this component through the parent, it decays as the hot set is rebuilt.
+        std::atomic<std::uint32_t> AccessCount {0};
+
+        /**
+         * @brief Rebuild the hot set with the most frequently accessed sub components.
+         * @details The hot set is allocated if it does not exist yet.
+         *          The sub components mutex must be exclusively locked by the caller.
+         */
+        void RebuildHotSet();
+        /**
+         * @brief Remove the sub component with the given hash code from the hot set.
+         * @param hash The hash code of the sub component.
+         * @details The sub components mutex must be exclusively locked by the caller.
+         */
+        void EvictFromHotSet(std::size_t hash) noexcept;
+        /**
+         * @brief Record the hash code of a newly inserted sub component and add it to the active ones if awake.
+         * @param hash The hash code of the sub component.
+         * @param component The sub component.
+         * @details The sub components mutex must be exclusively locked by the caller.
+         */
+        void ActivateSubComponent(std::size_t hash, Component* component) noexcept;
+        /**
+         * @brief Remove a sub component from the active ones by swapping it with the last one.
+         * @param component The sub component, nothing happens if it is not active.
+         * @details The sub components mutex must be exclusively locked by the caller.
+         */
+        void DeactivateSubComponent(Component* component) noexcept;
+        /**
+         * @brief Put this component to sleep or wake it up.
+         * @param asleep Whether this component should be asleep.
+         */
+        void SetAsleep(bool asleep);
+
+        /**
+         * @brief Insert a sub component into the sub components map and trigger the attaching events.
+         * @param hash The hash code of the component to insert.
+         * @param component The instance of the component to insert.
+         * @return The pointer to the inserted component.
+         * @details The sub components mutex must be exclusively locked by the caller.
+         *          Previous component with the same hash code will be replaced if it exist.
+         */
+        Component* InsertSubComponent(std::size_t hash, std::unique_ptr<Component>&& component);
+        /**
+         * @brief Find the factory of the lazy sub component with the given hash code.
+         * @param hash The hash code of the lazy sub component.
+         * @return Iterator to the factory, or the end iterator if it does not exist.
+         * @details The sub components mutex must be locked by the caller.
+         */
+        decltype(LazySubComponents)::iterator FindLazySubComponent(std::size_t hash);
+        /**
+         * @brief Construct the lazy sub component with the given hash code and insert it.
+         * @param hash The hash code of the lazy sub component.
+         * @return The pointer to the sub component, or nullptr if it neither exists nor is registered.
+         * @details The factory is invoked at most once, even if multiple threads access it at the same time.
+         */
+        Component* ConstructLazySubComponent(std::size_t hash);
+        /**
+         * @brief Register the factory of a sub component, which will be invoked when it is first accessed.
+         * @param hash The hash code of the component to register.
+         * @param factory The factory to construct the component.
+         * @details Previous component with the same hash code will be replaced if it exist.
+         */
+        void RegisterLazySubComponent(std::size_t hash, std::function<std::unique_ptr<Component>()> factory);
+        /**
+         * @brief Check whether a sub component with the given hash code exists or is registered.
+         * @param hash The hash code of the component to check.
+         */
+        bool HasSubComponent(std::size_t hash);
 
         /**
          * @brief Add a sub component to this component_instance.
@@ -32,6 +183,31 @@ namespace Gaia::Components
          * @details Previous component with the same hash code will be replaced if it exist.
          */
         Component* AddSubComponent(std::size_t hash, std::unique_ptr<Component>&& component);
+
+        /// Component staged by a tree builder, waiting to be merged into the tree.
+        struct StagedComponent
+        {
+            /// The parent to attach to, either a live component or another staged component.
+            Component* Parent;
+            /// The hash code of the staged component type.
+            std::size_t Hash;
+            /// Pointer to the staged component, it is set to nullptr once the component is discarded.
+            Component* Pointer;
+            /// Ownership of the staged component until it is inserted into its parent.
+            std::unique_ptr<Component> Instance;
+        };
+        /**
+         * @brief Attach staged components to their parents in one bulk step.
+         * @param staged The staged components, children must be staged after their parents.
+         * @return Count of the components which have been attached.
+         * @details Staged components under staged parents are linked without locking,
+         *          then every live parent is locked once to insert all of its staged components.
+         *          The events of the components merged under a live parent are triggered in the order of staging
+         *          while that parent is still locked, as AddComponent() does, so no other thread can remove them
+         *          before they are announced. Observers receive the events of the whole merge in one batch.
+         *          A staged component replaced by another staged one is discarded without any event.
+         */
+        static std::size_t MergeStagedComponents(std::vector<StagedComponent>& staged);
         /**
          * @brief Remove the sub component with the demanded hash code.
          * @param hash The hash code of the component to remove.
@@ -44,6 +220,17 @@ namespace Gaia::Components
          * @return The pointer to the sub component with the given hash code or nullptr if it does not exist.
          */
         Component* GetSubComponent(std::size_t hash);
+        /**
+         * @brief Get the sub components with the demanded hash code from many parents.
+         * @param hash The hash code of the components to get.
+         * @param parents Pointers to the parents.
+         * @param count Count of parents.
+         * @param results Output array for the sub components, nullptr is written for the missing ones.
+         * @details The parents of the next lookups are prefetched while the current lookup is running,
+         *          so that their cache misses overlap instead of happening one after another.
+         */
+        static void GetSubComponentBatch(std::size_t hash, Component* const* parents, std::size_t count,
+                                         Component** results);
         /**
          * @brief Separate a sub component into a individual component.
          * @param hash The hash code of the component to separate.
@@ -54,8 +241,158 @@ namespace Gaia::Components
         /// Pointer to the parent component.
         Component* Parent {nullptr};
 
-    protected:
+        /// Bloom filter of the type hash codes of all components in the subtree under this component.
+        std::atomic<std::uint64_t> SubtreeTypeSummary {0};
+        /// Whether the subtree type summary may still contain types which have been removed.
+        std::atomic<bool> SubtreeTypeSummaryStale {false};
+        /// Version number which will be increased on every structural change in the subtree.
+        std::atomic<std::uint64_t> SubtreeVersion {0};
+
+        /// Strand which serializes the messages posted to the subtree under this component,
+        /// it is accessed with the atomic shared pointer functions.
+        std::shared_ptr<Strand> BoundStrand;
 
+        /// Observers subscribed to the subtree under this component, it is created on the first subscription.
+        std::shared_ptr<ObserverHub> Observers;
+        /// Bloom filter of the type hash codes which are observed by any observer hub.
+        static std::atomic<std::uint64_t> ObservedTypes;
+
+        /**
+         * @brief Queue events for the observers of this component and its ancestors.
+         * @param type Type of the events.
+         * @param hash Type hash code of the attached or detached component.
+         * @param component The attached or detached component.
+         * @param announced Predicate of the components in the subtree which have events of their own,
+         *                  they and their subtrees are skipped.
+         * @details An event is queued for the component, and for every component of an observed type
+         *          in its subtree, which is attached or detached together with it.
+         *          Queued events are delivered in a batch after the outermost structural change
+         *          of the current thread finishes and releases its lock.
+         *          Types which no observer is interested in return at once.
+         */
+        void NotifyObservers(ComponentEventType type, std::size_t hash, Component* component,
+                             const std::function<bool(Component*)>& announced = {});
+        /// Queue an event for the observers of this component and its ancestors which are interested in its type.
+        void QueueObserverEvent(const ComponentEvent& event);
+        /**
+         * @brief Queue events for the observers of this component and its ancestors about the components
+         *        of observed types under the given subtree.
+         * @param type Type of the events.
+         * @param component The root of the subtree, it is not included.
+         * @param announced Predicate of the components which are skipped with their subtrees.
+         */
+        void QueueNestedObserverEvents(ComponentEventType type, Component* component,
+                                       const std::function<bool(Component*)>& announced);
+        /**
+         * @brief Subscribe to the structural change events of a component type in the subtree.
+         * @param hash Hash code of the component type to observe.
+         * @param callback Callback to deliver event batches to.
+         * @param executor Executor to deliver events on, or nullptr to deliver them synchronously.
+         * @return Identifier of the subscription.
+         */
+        std::size_t ObserveSubComponents(std::size_t hash, ComponentObserverCallback callback, Executor* executor);
+
+        /// Readiness state of this component.
+        std::atomic<ComponentState> State {ComponentState::Ready};
+        /// Future which will be ready when the asynchronous attaching of this component settles.
+        std::shared_future<void> AttachingTask;
+
+        /**
+         * @brief Add a sub component and run its asynchronous attaching on the given executor.
+         * @param executor The executor to run OnAttachedAsync() of the component on.
+         * @param hash The hash code of the component to add.
+         * @param component The instance of the component to add.
+         * @param on_settled Callback invoked on the executor with the component and the exception thrown by
+         *                   OnAttachedAsync(), if any, right before the asynchronous attaching settles.
+         * @return The pointer to the newly added component.
+         */
+        Component* AddSubComponentAsync(Executor& executor, std::size_t hash, std::unique_ptr<Component>&& component,
+                                        std::function<void(Component*, std::exception_ptr)> on_settled);
+        /**
+         * @brief Move an attached component to another address and fix up its parent.
+         * @param component The component to relocate.
+         * @param move_construct Function which move constructs the component at the new address,
+         *                       and returns the pointer to the new instance.
+         * @retval true The component has been relocated, the old instance is moved from and must be destroyed
+         *              without being deallocated through the parent.
+         * @retval false The component is not attached or its attaching has not settled, nothing has been done.
+         */
+        static bool RelocateSubComponent(Component* component, const std::function<Component*()>& move_construct);
+
+        /// Address of this component shared with its handles, it follows relocations and is cleared on destruction.
+        /// It is created on the first request of a handle, and is accessed with the atomic shared pointer functions.
+        std::shared_ptr<std::atomic<Component*>> Anchor;
+        /// Get the anchor of this component, creating it if it does not exist yet.
+        std::shared_ptr<const std::atomic<Component*>> GetAnchor();
+        /**
+         * @brief Wait for the asynchronous attaching of the sub component with the given hash code to settle.
+         * @param hash The hash code of the sub component.
+         * @details Sub components are only destroyed after their attaching settles,
+         *          because OnAttachedAsync() may still be using them.
+         */
+        void WaitForSubComponentAttaching(std::size_t hash);
+        /**
+         * @brief Wait for the asynchronous attaching of all sub components to settle.
+         * @details The sub components mutex must not be locked by the caller.
+         *          Components added by other threads meanwhile may still be attaching when this function returns.
+         */
+        void WaitForSubComponentsAttaching();
+        /// Check whether the asynchronous attaching of this component has settled, or there is none.
+        [[nodiscard]] bool IsSettled() const;
+        /**
+         * @brief Exclusively lock the sub components once the sub component with the given hash code is settled.
+         * @param hash The hash code of the sub component.
+         * @return The lock of the sub components mutex.
+         * @details The waiting is done without holding the lock, and is repeated if another attaching component
+         *          has been added with the same hash code before the lock is acquired.
+         */
+        std::unique_lock<std::shared_mutex> LockSettledSubComponent(std::size_t hash);
+
+        /**
+         * @brief Get the bits in the subtree type summary which represent the given type hash code.
+         * @param hash The type hash code.
+         * @return Bloom filter bits of the given hash code.
+         */
+        static std::uint64_t GetTypeSummaryBits(std::size_t hash) noexcept;
+        /**
+         * @brief Merge the given summary bits into this component and all its ancestors.
+         * @param bits Bloom filter bits of the types which are newly added into this subtree.
+         */
+        void PropagateSubtreeTypes(std::uint64_t bits);
+        /**
+         * @brief Mark the summaries of this component and all its ancestors as stale.
+         * @details Stale summaries will be recomputed the next time they are queried.
+         */
+        void InvalidateSubtreeTypes();
+        /**
+         * @brief Visit all components with the given type hash code in the subtree under this component.
+         * @param hash The type hash code of components to visit.
+         * @param visitor Visitor to invoke on every matched component.
+         * @details Subtrees whose type summary can not contain the given type will be skipped.
+         */
+        void VisitSubtree(std::size_t hash, const std::function<void(Component*)>& visitor);
+        /**
+         * @brief Attach a value, replacing the existing value of the same type.
+         * @param value Holder of the value to attach.
+         * @return Address of the attached value.
+         */
+        void* InsertValue(ComponentValue value);
+        /// Get the address of the value with the given type hash code, or nullptr if it does not exist.
+        void* FindValue(std::size_t hash);
+        /// Remove the value with the given type hash code, return false if it does not exist.
+        bool EraseValue(std::size_t hash);
+
+        /**
+         * @brief Take the sub components and the subtree state of another component.
+         * @param other The component to take from, it will be left without sub components.
+         * @details The state of this component in its parent, such as the readiness and the sleeping,
+         *          is not taken.
+         *          The sub components mutexes of both components must be exclusively locked by the caller,
+         *          and this component must not have any sub component.
+         */
+        void TakeSubComponents(Component& other);
+
+    protected:
         /**
          * @brief Get the pointer to the parent component instance.
          * @tparam ComponentType The type of parent component to convert the pointer into.
@@ -97,17 +434,213 @@ namespace Gaia::Components
          * @details This function will be invoked after the OnDetachedFromComponent() of the sub component.
          */
         virtual void OnComponentDetached(Component* component);
+        /**
+         * @brief Triggered on an executor after this component is added by AddComponentAsync().
+         * @details This function runs after OnAttachedToComponent() and without holding any lock,
+         *          so it can do slow setup such as loading files.
+         *          The component is in the Attaching state until this function returns,
+         *          and in the Failed state if it throws.
+         *          This function will do nothing by default.
+         */
+        virtual void OnAttachedAsync();
 
     public:
+        Component() = default;
         /// Destructor which will invoke OnDetachedFromComponent() for all existing sub components.
         virtual ~Component();
 
-        /// Get all sub components of this component.
+        /**
+         * @brief Move the sub components and the state of another component into this new component.
+         * @param other The component to move from, it will be left without sub components.
+         * @details The parent pointers of the moved sub components are updated to this component,
+         *          so components can be stored by value in containers such as std::vector.
+         *          The new component is not attached to any parent.
+         *          The other component must not be attaching asynchronously.
+         */
+        Component(Component&& other) noexcept;
+        /**
+         * @brief Replace the sub components and the state of this component with those of another component.
+         * @param other The component to move from, it will be left without sub components.
+         * @return This component.
+         * @details The previous sub components are detached and destroyed as the destructor does,
+         *          their OnDetachedFromComponent() is invoked after the sub components of both components
+         *          are unlocked. This component stays attached to its current parent,
+         *          and keeps its own readiness state and asynchronous attaching.
+         *          It blocks until the asynchronous attaching of the sub components of both components settles,
+         *          and it is not noexcept, because detaching hooks and destructors of the previous sub components
+         *          run inside it.
+         */
+        Component& operator=(Component&& other);
+
+        /// Get all sub components of this component, lazy components which are not constructed yet are excluded.
         [[nodiscard]] const decltype(SubComponents)& GetComponents() const noexcept
         {
             return SubComponents;
         }
 
+        /**
+         * @brief Invoke the visitor on every constructed sub component while holding the read lock.
+         * @param visitor Visitor to invoke, it must not add or remove sub components of this component.
+         */
+        void ForEachComponent(const std::function<void(Component*)>& visitor);
+
+        /**
+         * @brief Get the sub components which are awake, with their hash codes.
+         * @details The order is not stable: putting a sub component to sleep moves the last one into its place.
+         */
+        [[nodiscard]] const decltype(ActiveSubComponents)& GetActiveComponents() const noexcept
+        {
+            return ActiveSubComponents;
+        }
+
+        /**
+         * @brief Invoke the visitor on every sub component which is awake while holding the read lock.
+         * @param visitor Visitor to invoke, it must not add or remove sub components of this component.
+         */
+        void ForEachActiveComponent(const std::function<void(Component*)>& visitor);
+
+        /**
+         * @brief Put this component and its subtree to sleep.
+         * @details A sleeping component stays attached and accessible through GetComponent(),
+         *          but it is moved out of the active sub components of its parent,
+         *          so subtree traversals and update dispatching skip its whole subtree at no per-frame cost.
+         */
+        void Sleep();
+        /// Wake this component up, it is put back into the active sub components of its parent.
+        void Wake();
+        /// Check whether this component is asleep.
+        [[nodiscard]] bool IsAsleep() const noexcept;
+        /// Check whether neither this component nor any of its ancestors is asleep.
+        [[nodiscard]] bool IsAwakeInTree() const noexcept;
+
+        /**
+         * @brief Get the version number of the subtree under this component.
+         * @return Version number which increases on every structural change in the subtree.
+         * @details Caches of the subtree structure can compare it to find out whether they are outdated.
+         */
+        [[nodiscard]] std::uint64_t GetSubtreeVersion() const noexcept
+        {
+            return SubtreeVersion.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Get the type summary of the subtree under this component.
+         * @return Bloom filter of the type hash codes of all components in the subtree.
+         * @details The summary is maintained incrementally when components are added,
+         *          and recomputed lazily here after components are removed or separated.
+         *          It may have false positive bits, but never false negative ones.
+         */
+        std::uint64_t GetSubtreeTypeSummary();
+
+        /**
+         * @brief Check whether the subtree under this component may contain a component of the given type.
+         * @tparam ComponentType Type of the component to check.
+         * @retval true The subtree may contain a component of the given type.
+         * @retval false The subtree definitely does not contain a component of the given type.
+         */
+        template <typename ComponentType>
+        bool MayContainInSubtree()
+        {
+            auto bits = GetTypeSummaryBits(typeid(ComponentType).hash_code());
+            return (GetSubtreeTypeSummary() & bits) == bits;
+        }
+
+        /**
+         * @brief Invoke the visitor on every component of the given type in the subtree under this component.
+         * @tparam ComponentType Type of components to visit.
+         * @tparam Visitor Type of the visitor, which should be invocable with ComponentType*.
+         * @param visitor Visitor to invoke on every component of the given type.
+         * @details Subtrees which can not contain the given type will be skipped without being walked,
+         *          and so will the subtrees of sleeping components.
+         *          The visitor is invoked while the parent of the visited component is read locked,
+         *          so it must not add or remove components on that parent.
+         */
+        template <typename ComponentType, typename Visitor>
+        void ForEachComponentInSubtree(Visitor&& visitor)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            VisitSubtree(typeid(ComponentType).hash_code(), [&visitor](Component* component){
+                visitor(static_cast<ComponentType*>(component));
+            });
+        }
+
+        /**
+         * @brief Find all components of the given type in the subtree under this component.
+         * @tparam ComponentType Type of components to find.
+         * @return Pointers to all components of the given type in the subtree.
+         */
+        template <typename ComponentType>
+        std::vector<ComponentType*> FindComponentsInSubtree()
+        {
+            std::vector<ComponentType*> components;
+            ForEachComponentInSubtree<ComponentType>([&components](ComponentType* component){
+                components.push_back(component);
+            });
+            return components;
+        }
+
+        /**
+         * @brief Bind the subtree under this component to the given strand.
+         * @param strand The strand to bind, or nullptr to unbind and use the strand of the ancestors.
+         * @details Binding can be done concurrently with posting, messages posted after it returns
+         *          are run on the new strand.
+         */
+        void BindStrand(std::shared_ptr<Strand> strand);
+
+        /**
+         * @brief Get the strand which this component is bound to.
+         * @return The strand bound to this component or its nearest ancestor, or nullptr if there is none.
+         */
+        [[nodiscard]] std::shared_ptr<Strand> GetStrand() const;
+
+        /**
+         * @brief Post a message to the strand which this component is bound to.
+         * @param message The message to run on the strand.
+         * @retval true The message has been posted.
+         * @retval false This component is not bound to any strand, the message is discarded.
+         * @details Messages posted to the components in the same strand run one by one,
+         *          so they can access the components without locking each other out.
+         */
+        bool Post(std::function<void()> message);
+
+        /// Get the readiness state of this component.
+        [[nodiscard]] ComponentState GetState() const noexcept
+        {
+            return State.load();
+        }
+
+        /// Wait until the asynchronous attaching of this component settles, return immediately if there is none.
+        void WaitUntilSettled() const;
+
+        /**
+         * @brief Observe the components of the given type being added to or removed from the subtree.
+         * @tparam ComponentType Type of the components to observe.
+         * @param callback Callback to deliver event batches to, it must not throw.
+         * @param executor Executor to deliver events on, or nullptr to deliver them synchronously.
+         * @return Identifier of the subscription, which is used to cancel it.
+         * @details Events are reported for the component which is added or removed, and for the components
+         *          of the observed type under it, such as when a prebuilt entity is adopted or separated;
+         *          the parent of such an event is the direct parent of the nested component.
+         *          Synchronous observers receive the events of a structural change in one batch
+         *          right after the change releases its lock; asynchronous observers receive the events which
+         *          arrive before their delivery task runs in one batch.
+         *          Changes of unobserved types do not pay for the observers.
+         */
+        template <typename ComponentType>
+        std::size_t Observe(ComponentObserverCallback callback, Executor* executor = nullptr)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            return ObserveSubComponents(typeid(ComponentType).hash_code(), std::move(callback), executor);
+        }
+
+        /**
+         * @brief Cancel an observer subscription.
+         * @param identifier Identifier returned by Observe().
+         */
+        void Unobserve(std::size_t identifier);
+
         /**
          * @brief Check whether this component has the sub component of the given type or not.
          * @tparam ComponentType Type of sub component.
@@ -117,7 +650,7 @@ namespace Gaia::Components
         template <typename ComponentType>
         bool HasComponent()
         {
-            return GetSubComponent(typeid(ComponentType).hash_code()) != nullptr;
+            return HasSubComponent(typeid(ComponentType).hash_code());
         }
 
         /**
@@ -138,6 +671,98 @@ namespace Gaia::Components
                                     std::make_unique<ComponentType>(arguments...)));
         }
 
+        /**
+         * @brief Add a sub component and finish its attaching asynchronously on the given executor.
+         * @tparam ComponentType The type of the component to construct and add.
+         * @tparam ConstructorArguments The types of arguments to pass to the sub component constructor.
+         * @param executor The executor to run OnAttachedAsync() of the component on.
+         * @param arguments Arguments to pass to the sub component constructor.
+         * @return Future of the pointer to the newly added component,
+         *         which will be ready when OnAttachedAsync() of the component returns,
+         *         or hold the exception thrown by it.
+         * @details The component is visible through GetComponent() at once, in the Attaching state.
+         *          Use GetReadyComponent() to only get it after it is ready.
+         *          Previous component with the same type will be replaced if it exist.
+         */
+        template <typename ComponentType, typename... ConstructorArguments,
+                  typename = std::enable_if_t<std::is_constructible_v<ComponentType, ConstructorArguments...>>>
+        std::shared_future<ComponentType*> AddComponentAsync(Executor& executor, ConstructorArguments... arguments)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            auto promise = std::make_shared<std::promise<ComponentType*>>();
+            auto future = promise->get_future().share();
+            AddSubComponentAsync(executor, typeid(ComponentType).hash_code(),
+                                 std::make_unique<ComponentType>(arguments...),
+                                 [promise](Component* component, std::exception_ptr exception){
+                if (exception) promise->set_exception(exception);
+                else promise->set_value(static_cast<ComponentType*>(component));
+            });
+            return future;
+        }
+
+        /**
+         * @brief Add a sub component and continue with the given callback once its asynchronous attaching settles.
+         * @tparam ComponentType The type of the component to construct and add.
+         * @tparam ConstructorArguments The types of arguments to pass to the sub component constructor.
+         * @param executor The executor to run OnAttachedAsync() of the component on.
+         * @param on_settled Continuation invoked on the executor with the component and the exception thrown by
+         *                   OnAttachedAsync(), if any, it must not throw.
+         *                   It can resume a coroutine without blocking any thread.
+         * @param arguments Arguments to pass to the sub component constructor.
+         * @return The pointer to the newly added component, in the Attaching state.
+         * @details The continuation runs before the attaching settles, so the component is neither removed nor
+         *          relocated by other threads until it returns. It must not remove or replace the component itself,
+         *          which would wait for the attaching to settle, but it may post such changes to the executor.
+         */
+        template <typename ComponentType, typename... ConstructorArguments>
+        ComponentType* AddComponentAsync(Executor& executor,
+                                         std::function<void(ComponentType*, std::exception_ptr)> on_settled,
+                                         ConstructorArguments... arguments)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            return static_cast<ComponentType*>(AddSubComponentAsync(
+                    executor, typeid(ComponentType).hash_code(), std::make_unique<ComponentType>(arguments...),
+                    [on_settled = std::move(on_settled)](Component* component, std::exception_ptr exception){
+                on_settled(static_cast<ComponentType*>(component), std::move(exception));
+            }));
+        }
+
+        /**
+         * @brief Register a sub component which will be constructed when it is first accessed.
+         * @tparam ComponentType The type of the component to register.
+         * @tparam Factory The type of the factory, which should return std::unique_ptr<ComponentType>.
+         * @param factory The factory to construct the component.
+         * @details Until it is constructed, the component only occupies a factory slot in this component,
+         *          HasComponent() returns true for it and GetComponents() does not contain it.
+         *          The first GetComponent() constructs it exactly once, even if invoked from multiple threads,
+         *          and then triggers the attaching events as AddComponent() does.
+         *          The factory is invoked while this component is exclusively locked,
+         *          so it must not access this component.
+         *          Previous component with the same type will be replaced if it exist.
+         */
+        template <typename ComponentType, typename Factory>
+        void RegisterLazyComponent(Factory factory)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            RegisterLazySubComponent(typeid(ComponentType).hash_code(),
+                                     [factory = std::move(factory)]() -> std::unique_ptr<Component> {
+                return factory();
+            });
+        }
+
+        /**
+         * @brief Register a sub component which will be default constructed when it is first accessed.
+         * @tparam ComponentType The type of the component to register.
+         */
+        template <typename ComponentType>
+        void RegisterLazyComponent()
+        {
+            RegisterLazyComponent<ComponentType>([]{ return std::make_unique<ComponentType>(); });
+        }
+
         /**
          * @brief Adopt a component instance to this component.
          * @tparam ComponentType The type of the component to adopt and add.
@@ -183,6 +808,49 @@ namespace Gaia::Components
             return dynamic_cast<ComponentType*>(GetSubComponent(typeid(ComponentType).hash_code()));
         }
 
+        /**
+         * @brief Get the component instance of the given type if it is ready.
+         * @tparam ComponentType The type of the component to get.
+         * @return The instance of the given component type, or nullptr if the sub component with the given type
+         *         does not exist or its asynchronous attaching has not successfully finished.
+         */
+        template <typename ComponentType>
+        ComponentType* GetReadyComponent()
+        {
+            auto* component = GetComponent<ComponentType>();
+            if (component && component->GetState() == ComponentState::Ready) return component;
+            return nullptr;
+        }
+
+        /**
+         * @brief Get the component instances of the given type from many parents.
+         * @tparam ComponentType The type of the components to get.
+         * @param parents Pointers to the parents, which must not be nullptr.
+         * @param count Count of parents.
+         * @param results Output array of count elements, the instance of the given type of each parent
+         *                or nullptr if the parent does not have it will be written into it.
+         * @details Equivalent to invoking GetComponent() on each parent in turn,
+         *          but the memory latency of the lookups is hidden by prefetching the next parents.
+         */
+        template <typename ComponentType>
+        static void GetComponentBatch(Component* const* parents, std::size_t count, ComponentType** results)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            constexpr std::size_t chunk_size = 64;
+            Component* components[chunk_size];
+            for (std::size_t offset = 0; offset < count; offset += chunk_size)
+            {
+                auto chunk_count = std::min(chunk_size, count - offset);
+                GetSubComponentBatch(typeid(ComponentType).hash_code(), parents + offset, chunk_count, components);
+                // Components stored under the hash code of a type are always instances of that type.
+                for (std::size_t index = 0; index < chunk_count; ++index)
+                {
+                    results[offset + index] = static_cast<ComponentType*>(components[index]);
+                }
+            }
+        }
+
         /**
          * @brief Get or create the component if it does not exist.
          * @tparam ComponentType Component type to acquire.
@@ -212,5 +880,60 @@ namespace Gaia::Components
                     dynamic_cast<ComponentType*>(
                             SeparateSubComponent(typeid(ComponentType).hash_code()).release()));
         }
+
+        /**
+         * @brief Attach a plain value of the given type, replacing the existing one.
+         * @tparam ValueType Type of the value, it does not need to derive from Component.
+         * @param arguments Arguments to pass to the constructor of the value.
+         * @return Pointer to the attached value.
+         * @details Values are stored compactly inside this component: small values are stored inline,
+         *          and no vtable, mutex or sub components map is paid per value.
+         *          Values receive no attaching callbacks and are not observable.
+         *          Pointers to values are invalidated by adding or removing any value of this component.
+         */
+        template <typename ValueType, typename... Arguments>
+        ValueType* AddValue(Arguments&&... arguments)
+        {
+            static_assert(!std::is_base_of_v<Component, ValueType>,
+                          "Components should be attached with AddComponent().");
+            static_assert(std::is_move_constructible_v<ValueType>, "ValueType must be move constructible.");
+            return static_cast<ValueType*>(InsertValue(ComponentValue::Make<ValueType>(
+                    typeid(ValueType).hash_code(), std::forward<Arguments>(arguments)...)));
+        }
+
+        /**
+         * @brief Get the attached value of the given type.
+         * @tparam ValueType Type of the value.
+         * @return Pointer to the value, or nullptr if it does not exist.
+         */
+        template <typename ValueType>
+        ValueType* GetValue()
+        {
+            return static_cast<ValueType*>(FindValue(typeid(ValueType).hash_code()));
+        }
+
+        /**
+         * @brief Check whether a value of the given type is attached.
+         * @tparam ValueType Type of the value.
+         * @retval true The value exists.
+         * @retval false The value does not exist.
+         */
+        template <typename ValueType>
+        bool HasValue()
+        {
+            return FindValue(typeid(ValueType).hash_code()) != nullptr;
+        }
+
+        /**
+         * @brief Remove and destroy the attached value of the given type.
+         * @tparam ValueType Type of the value.
+         * @retval true The value has been removed.
+         * @retval false The value does not exist.
+         */
+        template <typename ValueType>
+        bool RemoveValue()
+        {
+            return EraseValue(typeid(ValueType).hash_code());
+        }
     };
 }
\ No newline at end of file
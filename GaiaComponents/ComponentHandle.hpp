@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief Handle to a component which stays valid when the component is relocated or destroyed.
+     * @tparam ComponentType Type of the component.
+     * @details The handle resolves the component through an anchor shared with the component:
+     *          relocating the component by pool compaction moves the anchor to the new instance,
+     *          and destroying the component clears it, so the handle never dangles.
+     *          Registries which keep components across frames should keep handles instead of raw pointers.
+     *          Resolving a handle is an atomic load; it does not synchronize with the destruction of the component
+     *          on another thread.
+     */
+    template <typename ComponentType>
+    class ComponentHandle
+    {
+        static_assert(std::is_base_of_v<Component, ComponentType>,
+                      "ComponentType must be derived from Component.");
+
+    private:
+        /// Anchor shared with the component, or nullptr for an empty handle.
+        std::shared_ptr<const std::atomic<Component*>> Anchor;
+
+    public:
+        ComponentHandle() = default;
+
+        /**
+         * @brief Construct a handle to the given component.
+         * @param component The component to refer to, or nullptr for an empty handle.
+         */
+        explicit ComponentHandle(ComponentType* component) :
+            Anchor(component != nullptr ? component->GetAnchor() : nullptr)
+        {}
+
+        /**
+         * @brief Get the component.
+         * @return The pointer to the current instance, or nullptr if the handle is empty or the component is destroyed.
+         */
+        ComponentType* Get() const noexcept
+        {
+            if (Anchor == nullptr) return nullptr;
+            return static_cast<ComponentType*>(Anchor->load(std::memory_order_acquire));
+        }
+
+        ComponentType* operator->() const noexcept
+        {
+            return Get();
+        }
+
+        ComponentType& operator*() const noexcept
+        {
+            return *Get();
+        }
+
+        /// Check whether the component is still alive.
+        explicit operator bool() const noexcept
+        {
+            return Get() != nullptr;
+        }
+
+        /// Check whether both handles refer to the same component, or both are empty.
+        bool operator==(const ComponentHandle& other) const noexcept
+        {
+            return Anchor == other.Anchor;
+        }
+
+        bool operator!=(const ComponentHandle& other) const noexcept
+        {
+            return Anchor != other.Anchor;
+        }
+
+        /// Release the anchor and make this handle empty.
+        void Reset() noexcept
+        {
+            Anchor.reset();
+        }
+
+        /// Get the hash code of the component identity, which stays the same when the component is relocated.
+        [[nodiscard]] std::size_t GetIdentityHash() const noexcept
+        {
+            return std::hash<const void*>()(Anchor.get());
+        }
+    };
+}
+
+namespace std
+{
+    template <typename ComponentType>
+    struct hash<Gaia::Components::ComponentHandle<ComponentType>>
+    {
+        std::size_t operator()(const Gaia::Components::ComponentHandle<ComponentType>& handle) const noexcept
+        {
+            return handle.GetIdentityHash();
+        }
+    };
+}
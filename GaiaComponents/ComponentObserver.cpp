@@ -0,0 +1,100 @@
+#include "ComponentObserver.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "Executor.hpp"
+
+namespace Gaia::Components
+{
+    /// Subscribe to the events of the given component type.
+    std::size_t ObserverHub::Subscribe(std::size_t hash, ComponentObserverCallback callback, Executor* executor)
+    {
+        auto subscription = std::make_shared<Subscription>();
+        subscription->TypeHash = hash;
+        subscription->Callback = std::move(callback);
+        subscription->TargetExecutor = executor;
+
+        std::unique_lock lock(SubscriptionsMutex);
+        subscription->Identifier = NextIdentifier++;
+        Subscriptions.push_back(subscription);
+        return subscription->Identifier;
+    }
+
+    /// Cancel a subscription.
+    void ObserverHub::Unsubscribe(std::size_t identifier)
+    {
+        std::unique_lock lock(SubscriptionsMutex);
+
+        auto finder = std::find_if(Subscriptions.begin(), Subscriptions.end(), [identifier](const auto& subscription){
+            return subscription->Identifier == identifier;
+        });
+        if (finder != Subscriptions.end())
+        {
+            (*finder)->Active.store(false);
+            Subscriptions.erase(finder);
+        }
+    }
+
+    /// Check whether any observer is interested in the given component type.
+    bool ObserverHub::IsObserving(std::size_t hash)
+    {
+        std::shared_lock lock(SubscriptionsMutex);
+
+        return std::any_of(Subscriptions.begin(), Subscriptions.end(), [hash](const auto& subscription){
+            return subscription->TypeHash == hash;
+        });
+    }
+
+    /// Deliver a batch of events to the interested observers.
+    void ObserverHub::Deliver(const std::vector<ComponentEvent>& events)
+    {
+        std::vector<std::shared_ptr<Subscription>> subscriptions;
+        {
+            std::shared_lock lock(SubscriptionsMutex);
+            subscriptions = Subscriptions;
+        }
+
+        std::vector<ComponentEvent> batch;
+        for (auto& subscription : subscriptions)
+        {
+            batch.clear();
+            std::copy_if(events.begin(), events.end(), std::back_inserter(batch), [&subscription](const auto& event){
+                return event.TypeHash == subscription->TypeHash;
+            });
+            if (batch.empty()) continue;
+
+            if (subscription->TargetExecutor == nullptr)
+            {
+                subscription->Callback(batch);
+                continue;
+            }
+
+            std::unique_lock lock(subscription->PendingMutex);
+            subscription->PendingEvents.insert(subscription->PendingEvents.end(), batch.begin(), batch.end());
+            // Events arriving before the posted task runs are coalesced into the same batch.
+            if (!subscription->DeliveryScheduled)
+            {
+                subscription->DeliveryScheduled = true;
+                ScheduleDelivery(subscription);
+            }
+        }
+    }
+
+    /// Post a task to deliver the pending events of the given subscription.
+    void ObserverHub::ScheduleDelivery(const std::shared_ptr<Subscription>& subscription)
+    {
+        subscription->TargetExecutor->Post([subscription]{
+            std::vector<ComponentEvent> batch;
+            {
+                std::unique_lock lock(subscription->PendingMutex);
+                batch.swap(subscription->PendingEvents);
+                subscription->DeliveryScheduled = false;
+            }
+            if (subscription->Active.load())
+            {
+                subscription->Callback(batch);
+            }
+        });
+    }
+}
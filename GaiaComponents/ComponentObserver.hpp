@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace Gaia::Components
+{
+    class Component;
+    class Executor;
+
+    /// Type of structural change events.
+    enum class ComponentEventType
+    {
+        /// A component has been added to its parent.
+        Attached,
+        /// A component has been removed or separated from its parent.
+        Detached
+    };
+
+    /// Structural change event of a component tree.
+    struct ComponentEvent
+    {
+        /// Type of this event.
+        ComponentEventType Type;
+        /// Type hash code of the attached or detached component.
+        std::size_t TypeHash;
+        /// The parent which the component is attached to or detached from.
+        Component* Parent;
+        /**
+         * @brief The attached or detached component.
+         * @details A detached component may already be destroyed when the event is delivered,
+         *          so the pointer of a detached event is only an identity and must not be dereferenced.
+         */
+        Component* Target;
+    };
+
+    /// Callback which receives a batch of events.
+    using ComponentObserverCallback = std::function<void(const std::vector<ComponentEvent>&)>;
+
+    /**
+     * @brief ObserverHub holds the observers subscribed to the subtree under a component.
+     * @details It is created by Component when the first observer subscribes,
+     *          and delivers event batches to the observers which are interested in their types.
+     */
+    class ObserverHub
+    {
+    private:
+        /// An observer subscribed to a component type.
+        struct Subscription
+        {
+            /// Identifier of this subscription.
+            std::size_t Identifier;
+            /// Hash code of the component type to observe.
+            std::size_t TypeHash;
+            /// Callback to deliver event batches to.
+            ComponentObserverCallback Callback;
+            /// Executor to deliver events on, or nullptr to deliver them synchronously.
+            Executor* TargetExecutor;
+            /// Whether this subscription is still active.
+            std::atomic<bool> Active {true};
+            /// Mutex for the pending events.
+            std::mutex PendingMutex;
+            /// Events waiting to be delivered on the executor.
+            std::vector<ComponentEvent> PendingEvents;
+            /// Whether a delivery task has been posted to the executor.
+            bool DeliveryScheduled {false};
+        };
+
+        /// Mutex for subscriptions.
+        std::shared_mutex SubscriptionsMutex;
+        /// Active subscriptions.
+        std::vector<std::shared_ptr<Subscription>> Subscriptions;
+        /// Identifier for the next subscription.
+        std::size_t NextIdentifier {1};
+
+        /// Post a task to deliver the pending events of the given subscription.
+        static void ScheduleDelivery(const std::shared_ptr<Subscription>& subscription);
+
+    public:
+        /**
+         * @brief Subscribe to the events of the given component type.
+         * @param hash Hash code of the component type to observe.
+         * @param callback Callback to deliver event batches to, it must not throw.
+         * @param executor Executor to deliver events on, or nullptr to deliver them synchronously.
+         * @return Identifier of the subscription.
+         */
+        std::size_t Subscribe(std::size_t hash, ComponentObserverCallback callback, Executor* executor);
+
+        /**
+         * @brief Cancel a subscription.
+         * @param identifier Identifier of the subscription.
+         * @details Events already queued for asynchronous delivery will be discarded.
+         */
+        void Unsubscribe(std::size_t identifier);
+
+        /**
+         * @brief Check whether any observer is interested in the given component type.
+         * @param hash Hash code of the component type.
+         */
+        bool IsObserving(std::size_t hash);
+
+        /**
+         * @brief Deliver a batch of events to the interested observers.
+         * @param events Events which happened in the subtree of the component owning this hub.
+         */
+        void Deliver(const std::vector<ComponentEvent>& events);
+    };
+}
@@ -0,0 +1,201 @@
+#include "ComponentPool.hpp"
+
+#include <algorithm>
+
+namespace Gaia::Components
+{
+    /// Construct a pool.
+    ComponentPool::ComponentPool(std::size_t slot_size, std::size_t slot_alignment, RelocateFunction relocate,
+                                 std::size_t slots_per_page) :
+        SlotSize((slot_size + slot_alignment - 1) / slot_alignment * slot_alignment),
+        SlotAlignment(slot_alignment), SlotsPerPage(std::max<std::size_t>(slots_per_page, 1)), Relocate(relocate)
+    {}
+
+    /// Free all pages.
+    ComponentPool::~ComponentPool()
+    {
+        for (auto& [memory, page] : Pages)
+        {
+            ::operator delete(page->Memory, std::align_val_t(SlotAlignment));
+        }
+    }
+
+    /// Find the page which contains the given address.
+    ComponentPool::Page* ComponentPool::FindPage(const void* pointer)
+    {
+        auto* address = static_cast<const std::byte*>(pointer);
+        auto finder = Pages.upper_bound(address);
+        if (finder == Pages.begin()) return nullptr;
+        --finder;
+        if (address >= finder->first + SlotSize * SlotsPerPage) return nullptr;
+        return finder->second.get();
+    }
+
+    /// Free the memory of the given page and remove it.
+    void ComponentPool::FreePage(const std::byte* memory)
+    {
+        auto finder = Pages.find(memory);
+        if (finder->second.get() == AllocatingPage) AllocatingPage = nullptr;
+        ::operator delete(finder->second->Memory, std::align_val_t(SlotAlignment));
+        Pages.erase(finder);
+    }
+
+    /// Allocate a slot.
+    void* ComponentPool::Allocate()
+    {
+        std::unique_lock lock(PagesMutex);
+
+        // Keep filling the page of the last allocation, only search for the densest page when it is full.
+        Page* target_page = AllocatingPage;
+        if (target_page == nullptr || target_page->FreeSlots.empty())
+        {
+            target_page = nullptr;
+            for (auto& [memory, page] : Pages)
+            {
+                if (!page->FreeSlots.empty() && (target_page == nullptr || page->LiveCount > target_page->LiveCount))
+                {
+                    target_page = page.get();
+                }
+            }
+        }
+        if (target_page == nullptr)
+        {
+            auto page = std::make_unique<Page>();
+            page->Memory = static_cast<std::byte*>(
+                    ::operator new(SlotSize * SlotsPerPage, std::align_val_t(SlotAlignment)));
+            page->Occupied.resize(SlotsPerPage, false);
+            page->FreeSlots.reserve(SlotsPerPage);
+            for (std::size_t slot = SlotsPerPage; slot > 0; --slot)
+            {
+                page->FreeSlots.push_back(slot - 1);
+            }
+            target_page = page.get();
+            Pages.emplace(page->Memory, std::move(page));
+        }
+
+        AllocatingPage = target_page;
+        auto slot = target_page->FreeSlots.back();
+        target_page->FreeSlots.pop_back();
+        target_page->Occupied[slot] = true;
+        ++target_page->LiveCount;
+        return target_page->Memory + slot * SlotSize;
+    }
+
+    /// Deallocate a slot.
+    void ComponentPool::Deallocate(void* pointer)
+    {
+        std::unique_lock lock(PagesMutex);
+
+        auto* page = FindPage(pointer);
+        if (page == nullptr) return;
+        auto slot = static_cast<std::size_t>(static_cast<std::byte*>(pointer) - page->Memory) / SlotSize;
+        page->Occupied[slot] = false;
+        page->FreeSlots.push_back(slot);
+        if (--page->LiveCount == 0)
+        {
+            FreePage(page->Memory);
+        }
+    }
+
+    /// Relocate live instances from sparse pages into dense pages, until the budget is used up.
+    bool ComponentPool::Compact(std::chrono::steady_clock::duration budget)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + budget;
+        std::unique_lock compaction_lock(CompactionMutex);
+
+        // Instances which can not be relocated now, and pages which only have such instances left.
+        std::vector<const std::byte*> stuck_instances;
+        std::vector<const std::byte*> stuck_pages;
+
+        while (true)
+        {
+            std::byte* source = nullptr;
+            std::byte* destination = nullptr;
+            {
+                std::unique_lock lock(PagesMutex);
+
+                std::size_t live_count = 0;
+                for (auto& [memory, page] : Pages) live_count += page->LiveCount;
+                if (Pages.size() <= (live_count + SlotsPerPage - 1) / SlotsPerPage) return true;
+
+                // Evacuate the sparsest page into the densest page which still has free slots.
+                Page* source_page = nullptr;
+                for (auto& [memory, page] : Pages)
+                {
+                    if (std::find(stuck_pages.begin(), stuck_pages.end(), memory) != stuck_pages.end()) continue;
+                    if (source_page == nullptr || page->LiveCount < source_page->LiveCount)
+                    {
+                        source_page = page.get();
+                    }
+                }
+                if (source_page == nullptr) return true;
+
+                Page* destination_page = nullptr;
+                for (auto& [memory, page] : Pages)
+                {
+                    if (page.get() == source_page || page->FreeSlots.empty()) continue;
+                    if (destination_page == nullptr || page->LiveCount > destination_page->LiveCount)
+                    {
+                        destination_page = page.get();
+                    }
+                }
+                // Moving instances into a sparser page would not free any page.
+                if (destination_page == nullptr || destination_page->LiveCount < source_page->LiveCount) return true;
+
+                for (std::size_t slot = 0; slot < SlotsPerPage; ++slot)
+                {
+                    auto* address = source_page->Memory + slot * SlotSize;
+                    if (source_page->Occupied[slot] &&
+                        std::find(stuck_instances.begin(), stuck_instances.end(), address) == stuck_instances.end())
+                    {
+                        source = address;
+                        break;
+                    }
+                }
+                if (source == nullptr)
+                {
+                    stuck_pages.push_back(source_page->Memory);
+                    continue;
+                }
+
+                // Reserve the destination slot, so that allocations during relocating will not take it.
+                auto destination_slot = destination_page->FreeSlots.back();
+                destination_page->FreeSlots.pop_back();
+                destination_page->Occupied[destination_slot] = true;
+                ++destination_page->LiveCount;
+                destination = destination_page->Memory + destination_slot * SlotSize;
+            }
+
+            // Relocate without holding the lock, constructors and destructors may allocate from this pool.
+            if (Relocate(source, destination))
+            {
+                // The old instance has been destroyed in place, release its slot.
+                Deallocate(source);
+            }
+            else
+            {
+                Deallocate(destination);
+                stuck_instances.push_back(source);
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+        }
+    }
+
+    /// Get the count of pages.
+    std::size_t ComponentPool::GetPageCount()
+    {
+        std::unique_lock lock(PagesMutex);
+        return Pages.size();
+    }
+
+    /// Get the count of live instances.
+    std::size_t ComponentPool::GetLiveCount()
+    {
+        std::unique_lock lock(PagesMutex);
+
+        std::size_t live_count = 0;
+        for (auto& [memory, page] : Pages) live_count += page->LiveCount;
+        return live_count;
+    }
+}
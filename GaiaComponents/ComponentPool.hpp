@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <typeinfo>
+#include <vector>
+
+#include "Component.hpp"
+#include "ComponentHandle.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief ComponentPool allocates instances of one component type from pages of fixed size slots.
+     * @details Besides keeping instances of the same type close to each other, the pool can compact itself:
+     *          live instances in sparse pages are relocated into dense pages, and the emptied pages are freed.
+     */
+    class ComponentPool
+    {
+    public:
+        /**
+         * @brief Function which relocates the instance in the source slot into the destination slot.
+         * @retval true The instance has been move constructed in the destination slot and the source is destroyed.
+         * @retval false The instance can not be relocated now, both slots are left untouched.
+         */
+        using RelocateFunction = bool(*)(void* source, void* destination);
+
+    private:
+        /// A page of slots.
+        struct Page
+        {
+            /// Memory of the slots.
+            std::byte* Memory {nullptr};
+            /// Whether each slot is occupied by a live instance or not.
+            std::vector<bool> Occupied;
+            /// Indices of free slots.
+            std::vector<std::size_t> FreeSlots;
+            /// Count of live instances in this page.
+            std::size_t LiveCount {0};
+        };
+
+        /// Size of each slot.
+        const std::size_t SlotSize;
+        /// Alignment of each slot.
+        const std::size_t SlotAlignment;
+        /// Count of slots in each page.
+        const std::size_t SlotsPerPage;
+        /// Function to relocate instances while compacting.
+        const RelocateFunction Relocate;
+
+        /// Mutex for pages.
+        std::mutex PagesMutex;
+        /// Map the address of page memory to the page.
+        std::map<const std::byte*, std::unique_ptr<Page>> Pages;
+        /// The page which the last slot was allocated from.
+        Page* AllocatingPage {nullptr};
+        /// Mutex which only allows one compaction at a time.
+        std::mutex CompactionMutex;
+
+        /// Find the page which contains the given address, the pages mutex must be locked.
+        Page* FindPage(const void* pointer);
+        /// Free the memory of the given page and remove it, the pages mutex must be locked.
+        void FreePage(const std::byte* memory);
+
+    public:
+        /**
+         * @brief Construct a pool.
+         * @param slot_size Size of each slot.
+         * @param slot_alignment Alignment of each slot.
+         * @param relocate Function to relocate instances while compacting.
+         * @param slots_per_page Count of slots in each page.
+         */
+        ComponentPool(std::size_t slot_size, std::size_t slot_alignment, RelocateFunction relocate,
+                      std::size_t slots_per_page = 256);
+        /// Free all pages, all instances must have been deallocated.
+        ~ComponentPool();
+
+        ComponentPool(const ComponentPool&) = delete;
+        ComponentPool& operator=(const ComponentPool&) = delete;
+
+        /// Allocate a slot, the densest page with free slots is preferred to keep pages full.
+        void* Allocate();
+        /// Deallocate a slot, the page will be freed when it becomes empty.
+        void Deallocate(void* pointer);
+
+        /**
+         * @brief Relocate live instances from sparse pages into dense pages, until the budget is used up.
+         * @param budget Time budget of this compaction pass.
+         * @retval true The pool is compact, or nothing more can be relocated for now.
+         * @retval false The budget is used up before the pool becomes compact, invoke this function again later.
+         * @details Relocated instances move to new addresses, so raw pointers to them are invalidated,
+         *          while ComponentHandle follows them. Pin the instances which must stay in place,
+         *          and run compaction when no other thread is accessing the pooled components.
+         */
+        bool Compact(std::chrono::steady_clock::duration budget);
+
+        /// Get the count of pages.
+        [[nodiscard]] std::size_t GetPageCount();
+        /// Get the count of live instances.
+        [[nodiscard]] std::size_t GetLiveCount();
+    };
+
+    /**
+     * @brief Base class of components which are allocated from a compactable pool of their own type.
+     * @tparam ComponentType The final derived component type, which must be move constructible.
+     * @details Derive a component as `class Transform : public PooledComponent<Transform>`.
+     *          Instances of types further derived from ComponentType are allocated normally.
+     *          Only attached instances are relocated by compaction; their parent pointers and the child table
+     *          entries of their parents are fixed up, and so are the parent pointers of their sub components
+     *          and the handles to them. Keep a ComponentHandle instead of a raw pointer across compactions.
+     */
+    template <typename ComponentType>
+    class PooledComponent : public Component
+    {
+    private:
+        /// Count of pins which prevent this instance from being relocated.
+        std::atomic<std::uint32_t> PinCount {0};
+
+        /// Relocate the instance in the source slot into the destination slot.
+        static bool RelocateInstance(void* source, void* destination)
+        {
+            auto* instance = static_cast<ComponentType*>(source);
+            // Instances of further derived types with the same size would be sliced by moving.
+            if (instance->PinCount.load() > 0 || typeid(*instance) != typeid(ComponentType)) return false;
+            auto relocated = Component::RelocateSubComponent(instance, [instance, destination]() -> Component* {
+                return ::new (destination) ComponentType(std::move(*instance));
+            });
+            if (!relocated) return false;
+            instance->~ComponentType();
+            return true;
+        }
+
+    protected:
+        PooledComponent() = default;
+        PooledComponent(PooledComponent&& other) noexcept : Component(std::move(other))
+        {}
+
+    public:
+        /// Get the pool of this component type.
+        static ComponentPool& GetPool()
+        {
+            static ComponentPool pool(sizeof(ComponentType), alignof(ComponentType), &RelocateInstance);
+            return pool;
+        }
+
+        static void* operator new(std::size_t size)
+        {
+            if (size != sizeof(ComponentType)) return ::operator new(size);
+            return GetPool().Allocate();
+        }
+
+        static void operator delete(void* pointer, std::size_t size)
+        {
+            if (size != sizeof(ComponentType))
+            {
+                ::operator delete(pointer);
+                return;
+            }
+            GetPool().Deallocate(pointer);
+        }
+
+        /// Prevent this instance from being relocated by compaction until it is unpinned.
+        void Pin() noexcept
+        {
+            PinCount.fetch_add(1);
+        }
+
+        /// Allow this instance to be relocated again.
+        void Unpin() noexcept
+        {
+            PinCount.fetch_sub(1);
+        }
+    };
+}
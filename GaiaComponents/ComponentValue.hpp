@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Gaia::Components
+{
+    /**
+     * @brief Type-erased holder of a plain value attached to a component.
+     * @details Small values which can be moved without throwing are stored inline in the holder,
+     *          larger ones are stored in a separate heap allocation.
+     *          The holder itself only carries the type hash code and a pointer to the static operations of the type,
+     *          so a value does not pay for any of the members of Component.
+     */
+    class ComponentValue
+    {
+    public:
+        /// Size of the inline buffer, values which do not fit into it are stored on the heap.
+        static constexpr std::size_t InlineSize = 2 * sizeof(void*);
+        /// Alignment of the inline buffer.
+        static constexpr std::size_t InlineAlignment = alignof(void*);
+
+    private:
+        /// Type-specific operations on a stored value.
+        struct Operations
+        {
+            /// Destroy the value stored in the given holder.
+            void (*Destroy)(ComponentValue& holder) noexcept;
+            /// Move the value stored in the source holder into the empty destination holder.
+            void (*Move)(ComponentValue& source, ComponentValue& destination) noexcept;
+            /// Get the address of the value stored in the given holder.
+            void* (*Get)(ComponentValue& holder) noexcept;
+        };
+
+        /// Whether values of the given type are stored in the inline buffer.
+        template <typename ValueType>
+        static constexpr bool IsInline = sizeof(ValueType) <= InlineSize && alignof(ValueType) <= InlineAlignment &&
+                                         std::is_nothrow_move_constructible_v<ValueType>;
+
+        template <typename ValueType>
+        static void DestroyValue(ComponentValue& holder) noexcept
+        {
+            if constexpr (IsInline<ValueType>)
+            {
+                std::launder(reinterpret_cast<ValueType*>(holder.Storage.Buffer))->~ValueType();
+            }
+            else
+            {
+                delete static_cast<ValueType*>(holder.Storage.Pointer);
+            }
+        }
+
+        template <typename ValueType>
+        static void MoveValue(ComponentValue& source, ComponentValue& destination) noexcept
+        {
+            if constexpr (IsInline<ValueType>)
+            {
+                auto* value = std::launder(reinterpret_cast<ValueType*>(source.Storage.Buffer));
+                ::new (destination.Storage.Buffer) ValueType(std::move(*value));
+                value->~ValueType();
+            }
+            else
+            {
+                destination.Storage.Pointer = source.Storage.Pointer;
+            }
+        }
+
+        template <typename ValueType>
+        static void* GetValue(ComponentValue& holder) noexcept
+        {
+            if constexpr (IsInline<ValueType>)
+            {
+                return std::launder(reinterpret_cast<ValueType*>(holder.Storage.Buffer));
+            }
+            else
+            {
+                return holder.Storage.Pointer;
+            }
+        }
+
+        template <typename ValueType>
+        static constexpr Operations TypeOperations {&DestroyValue<ValueType>, &MoveValue<ValueType>,
+                                                    &GetValue<ValueType>};
+
+        /// Hash code of the type of the stored value.
+        std::size_t Hash;
+        /// Operations of the type of the stored value, null if this holder has been moved from.
+        const Operations* ValueOperations {nullptr};
+        /// Inline buffer or pointer to the heap allocation of the stored value.
+        union
+        {
+            void* Pointer;
+            alignas(InlineAlignment) unsigned char Buffer[InlineSize];
+        } Storage {};
+
+        ComponentValue(std::size_t hash, const Operations* operations) noexcept :
+            Hash(hash), ValueOperations(operations)
+        {}
+
+    public:
+        /**
+         * @brief Construct a holder with a value of the given type.
+         * @tparam ValueType Type of the value.
+         * @param hash Hash code of the value type.
+         * @param arguments Arguments to pass to the constructor of the value.
+         */
+        template <typename ValueType, typename... Arguments>
+        static ComponentValue Make(std::size_t hash, Arguments&&... arguments)
+        {
+            ComponentValue holder(hash, nullptr);
+            if constexpr (IsInline<ValueType>)
+            {
+                ::new (holder.Storage.Buffer) ValueType(std::forward<Arguments>(arguments)...);
+            }
+            else
+            {
+                holder.Storage.Pointer = new ValueType(std::forward<Arguments>(arguments)...);
+            }
+            holder.ValueOperations = &TypeOperations<ValueType>;
+            return holder;
+        }
+
+        ComponentValue(ComponentValue&& other) noexcept : Hash(other.Hash), ValueOperations(other.ValueOperations)
+        {
+            if (ValueOperations != nullptr)
+            {
+                ValueOperations->Move(other, *this);
+                other.ValueOperations = nullptr;
+            }
+        }
+
+        ComponentValue& operator=(ComponentValue&& other) noexcept
+        {
+            if (&other == this) return *this;
+            if (ValueOperations != nullptr) ValueOperations->Destroy(*this);
+            Hash = other.Hash;
+            ValueOperations = other.ValueOperations;
+            if (ValueOperations != nullptr)
+            {
+                ValueOperations->Move(other, *this);
+                other.ValueOperations = nullptr;
+            }
+            return *this;
+        }
+
+        ComponentValue(const ComponentValue&) = delete;
+        ComponentValue& operator=(const ComponentValue&) = delete;
+
+        ~ComponentValue()
+        {
+            if (ValueOperations != nullptr) ValueOperations->Destroy(*this);
+        }
+
+        /// Get the hash code of the type of the stored value.
+        [[nodiscard]] std::size_t GetHash() const noexcept
+        {
+            return Hash;
+        }
+
+        /// Get the address of the stored value.
+        [[nodiscard]] void* Get() noexcept
+        {
+            return ValueOperations->Get(*this);
+        }
+    };
+}
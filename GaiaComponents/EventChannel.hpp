@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief Interface of components which handle events of the given type.
+     * @tparam EventType Type of the events to handle.
+     */
+    template <typename EventType>
+    class EventHandler
+    {
+    public:
+        virtual ~EventHandler() = default;
+
+        /// Triggered when an event is published to a channel which this component is in the scope of.
+        virtual void OnEvent(const EventType& event) = 0;
+    };
+
+    /// Scope of the components which receive the events published to a channel.
+    enum class EventScope
+    {
+        /// The sub components of the scope component.
+        Siblings,
+        /// All components in the subtree under the scope component.
+        Subtree
+    };
+
+    /**
+     * @brief EventChannel publishes typed events to the handlers in a component scope.
+     * @tparam EventType Type of the events to publish.
+     * @details The handlers are resolved once and cached; publishing is a direct call on every cached handler.
+     *          The cache is only rebuilt when the subtree version of the scope component changes.
+     *          A channel is meant to be owned by one publisher, such as a component which binds it to its parent
+     *          in OnAttachedToComponent(), and is not safe to publish from multiple threads at the same time.
+     */
+    template <typename EventType>
+    class EventChannel
+    {
+    private:
+        /// The component whose sub components or subtree receive the events.
+        Component* ScopeComponent {nullptr};
+        /// Scope of the receivers.
+        EventScope Scope {EventScope::Siblings};
+        /// Subtree version of the scope component when the handlers were resolved.
+        std::uint64_t ResolvedVersion {std::numeric_limits<std::uint64_t>::max()};
+        /// Resolved handlers.
+        std::vector<EventHandler<EventType>*> Handlers;
+
+        /// Collect the handlers under the given component.
+        void CollectHandlers(Component* component)
+        {
+            component->ForEachComponent([this](Component* sub_component){
+                if (auto* handler = dynamic_cast<EventHandler<EventType>*>(sub_component))
+                {
+                    Handlers.push_back(handler);
+                }
+                if (Scope == EventScope::Subtree)
+                {
+                    CollectHandlers(sub_component);
+                }
+            });
+        }
+
+        /// Resolve the handlers again if the structure of the scope has changed.
+        void ResolveHandlers()
+        {
+            auto version = ScopeComponent->GetSubtreeVersion();
+            if (version == ResolvedVersion) return;
+            Handlers.clear();
+            CollectHandlers(ScopeComponent);
+            // Changes during collecting increase the version again, so they will be caught by the next publish.
+            ResolvedVersion = version;
+        }
+
+    public:
+        EventChannel() = default;
+
+        /**
+         * @brief Construct a channel bound to the given scope.
+         * @param scope_component The component whose sub components or subtree receive the events.
+         * @param scope Scope of the receivers.
+         */
+        explicit EventChannel(Component* scope_component, EventScope scope = EventScope::Siblings)
+        {
+            Bind(scope_component, scope);
+        }
+
+        /**
+         * @brief Bind this channel to the given scope.
+         * @param scope_component The component whose sub components or subtree receive the events,
+         *                        or nullptr to unbind this channel.
+         * @param scope Scope of the receivers.
+         */
+        void Bind(Component* scope_component, EventScope scope = EventScope::Siblings)
+        {
+            ScopeComponent = scope_component;
+            Scope = scope;
+            ResolvedVersion = std::numeric_limits<std::uint64_t>::max();
+            Handlers.clear();
+        }
+
+        /**
+         * @brief Publish an event to all handlers in the scope.
+         * @param event The event to publish.
+         * @details Handlers must not add or remove components in the scope while the event is published.
+         */
+        void Publish(const EventType& event)
+        {
+            if (ScopeComponent == nullptr) return;
+            ResolveHandlers();
+            for (auto* handler : Handlers)
+            {
+                handler->OnEvent(event);
+            }
+        }
+
+        /// Get the count of handlers which will receive the published events.
+        std::size_t GetHandlerCount()
+        {
+            if (ScopeComponent == nullptr) return 0;
+            ResolveHandlers();
+            return Handlers.size();
+        }
+    };
+}
@@ -0,0 +1,58 @@
+#include "Executor.hpp"
+
+#include <algorithm>
+
+namespace Gaia::Components
+{
+    /// Construct and start the worker threads.
+    Executor::Executor(std::size_t thread_count)
+    {
+        thread_count = std::max<std::size_t>(thread_count, 1);
+        Workers.reserve(thread_count);
+        for (std::size_t index = 0; index < thread_count; ++index)
+        {
+            Workers.emplace_back([this]{ RunWorker(); });
+        }
+    }
+
+    /// Run all tasks still queued, then stop and join the worker threads.
+    Executor::~Executor()
+    {
+        {
+            std::unique_lock lock(TasksMutex);
+            Stopping = true;
+        }
+        TasksCondition.notify_all();
+        for (auto& worker : Workers)
+        {
+            worker.join();
+        }
+    }
+
+    /// Post a task to run on a worker thread.
+    void Executor::Post(std::function<void()> task)
+    {
+        {
+            std::unique_lock lock(TasksMutex);
+            Tasks.push_back(std::move(task));
+        }
+        TasksCondition.notify_one();
+    }
+
+    /// Main loop of worker threads.
+    void Executor::RunWorker()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(TasksMutex);
+                TasksCondition.wait(lock, [this]{ return Stopping || !Tasks.empty(); });
+                if (Tasks.empty()) return;
+                task = std::move(Tasks.front());
+                Tasks.pop_front();
+            }
+            task();
+        }
+    }
+}
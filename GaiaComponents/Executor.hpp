@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Gaia::Components
+{
+    /**
+     * @brief Executor is a fixed pool of worker threads which run posted tasks.
+     * @details Services which need to run work in the background, such as strands, share an executor,
+     *          so the number of threads stays fixed no matter how many of them there are.
+     */
+    class Executor
+    {
+    private:
+        /// Worker threads of this executor.
+        std::vector<std::thread> Workers;
+        /// Mutex for the task queue.
+        std::mutex TasksMutex;
+        /// Condition variable to wake up idle workers.
+        std::condition_variable TasksCondition;
+        /// Tasks waiting to be run.
+        std::deque<std::function<void()>> Tasks;
+        /// Whether this executor is stopping or not.
+        bool Stopping {false};
+
+        /// Main loop of worker threads.
+        void RunWorker();
+
+    public:
+        /**
+         * @brief Construct and start the worker threads.
+         * @param thread_count Count of worker threads, it will be at least 1.
+         */
+        explicit Executor(std::size_t thread_count = std::thread::hardware_concurrency());
+        /// Run all tasks still queued, then stop and join the worker threads.
+        ~Executor();
+
+        Executor(const Executor&) = delete;
+        Executor& operator=(const Executor&) = delete;
+
+        /**
+         * @brief Post a task to run on a worker thread.
+         * @param task The task to run, it must not throw.
+         */
+        void Post(std::function<void()> task);
+
+        /// Get the count of worker threads.
+        [[nodiscard]] std::size_t GetThreadCount() const noexcept
+        {
+            return Workers.size();
+        }
+    };
+}
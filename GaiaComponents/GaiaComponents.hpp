@@ -1,6 +1,20 @@
 #pragma once
 
 #include "Component.hpp"
+#include "ColumnarExporter.hpp"
+#include "ComponentHandle.hpp"
+#include "ComponentObserver.hpp"
+#include "ComponentPool.hpp"
+#include "ComponentValue.hpp"
+#include "EventChannel.hpp"
+#include "Sibling.hpp"
+#include "BudgetScheduler.hpp"
+#include "Executor.hpp"
+#include "Strand.hpp"
+#include "SystemScheduler.hpp"
+#include "TieredUpdateScheduler.hpp"
+#include "TreeBuilder.hpp"
+#include "UpdateDispatcher.hpp"
 
 namespace Gaia::Components
 {}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief Reference to the sibling component of the given type, which follows structural changes.
+     * @tparam ComponentType Type of the sibling component.
+     * @details Declare it as a member of a component, and pass the owner component to the constructor:
+     *          @code Sibling<Transform> transform {this}; @endcode
+     *          The sibling is looked up once and cached. The cached pointer is only looked up again when
+     *          the owner is attached to another parent or the subtree version of the parent changes,
+     *          so it never dangles after the sibling is replaced, removed or separated.
+     *          A reference is not safe to access from multiple threads at the same time.
+     */
+    template <typename ComponentType>
+    class Sibling
+    {
+        static_assert(std::is_base_of_v<Component, ComponentType>,
+                      "ComponentType must be derived from Component.");
+
+    private:
+        /// Offset of this reference from the component which owns it, it stays valid when the owner is moved.
+        std::ptrdiff_t OwnerOffset;
+        /// The parent which the cached pointer was resolved in.
+        mutable Component* ResolvedParent {nullptr};
+        /// Subtree version of the parent when the cached pointer was resolved.
+        mutable std::uint64_t ResolvedVersion {std::numeric_limits<std::uint64_t>::max()};
+        /// Cached pointer to the sibling.
+        mutable ComponentType* Instance {nullptr};
+
+        /// Get the component which owns this reference.
+        Component* GetOwner() const noexcept
+        {
+            return reinterpret_cast<Component*>(
+                    const_cast<char*>(reinterpret_cast<const char*>(this)) - OwnerOffset);
+        }
+
+        /// Look up the sibling again if the owner or the structure of its parent has changed.
+        void Resolve() const
+        {
+            auto* parent = GetOwner()->Parent;
+            if (parent == nullptr)
+            {
+                ResolvedParent = nullptr;
+                Instance = nullptr;
+                return;
+            }
+            auto version = parent->GetSubtreeVersion();
+            if (parent == ResolvedParent && version == ResolvedVersion) return;
+            Instance = parent->template GetComponent<ComponentType>();
+            ResolvedParent = parent;
+            // Read before looking up, so changes during the lookup will be caught by the next access.
+            ResolvedVersion = version;
+        }
+
+    public:
+        /**
+         * @brief Construct a reference owned by the given component.
+         * @param owner The component which owns this reference, usually `this`.
+         *              This reference must be a data member of the owner.
+         */
+        explicit Sibling(Component* owner) :
+            OwnerOffset(reinterpret_cast<const char*>(this) - reinterpret_cast<const char*>(owner))
+        {}
+
+        /**
+         * @brief Construct the reference of a moved owner from the reference of the original owner.
+         * @details The reference is bound to the new owner at the same offset, and is resolved again on access.
+         */
+        Sibling(Sibling&& other) noexcept : OwnerOffset(other.OwnerOffset)
+        {}
+
+        /// Keep the binding to the owner of this reference, and resolve it again on the next access.
+        Sibling& operator=(Sibling&&) noexcept
+        {
+            ResolvedParent = nullptr;
+            ResolvedVersion = std::numeric_limits<std::uint64_t>::max();
+            Instance = nullptr;
+            return *this;
+        }
+
+        Sibling(const Sibling&) = delete;
+        Sibling& operator=(const Sibling&) = delete;
+
+        /**
+         * @brief Get the sibling component.
+         * @return The pointer to the sibling, or nullptr if the owner is not attached or it has no such sibling.
+         */
+        ComponentType* Get() const
+        {
+            Resolve();
+            return Instance;
+        }
+
+        ComponentType* operator->() const
+        {
+            return Get();
+        }
+
+        ComponentType& operator*() const
+        {
+            return *Get();
+        }
+
+        /// Check whether the sibling exists.
+        explicit operator bool() const
+        {
+            return Get() != nullptr;
+        }
+    };
+}
@@ -0,0 +1,121 @@
+#include "Strand.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace Gaia::Components
+{
+    namespace
+    {
+        /// The strand whose messages are running in the current thread.
+        thread_local const Strand* CurrentStrand = nullptr;
+    }
+
+    /// Construct a strand on the given executor.
+    Strand::Strand(Executor& executor, std::size_t batch_size) :
+        TargetExecutor(executor), BatchSize(batch_size > 0 ? batch_size : 1)
+    {}
+
+    /// Destroy all messages which have not been run.
+    Strand::~Strand()
+    {
+        while (PendingCount.load() > 0)
+        {
+            if (auto* node = Pop())
+            {
+                delete node;
+                PendingCount.fetch_sub(1);
+            }
+        }
+    }
+
+    /// Push a node into the mailbox.
+    void Strand::Push(MessageNode* node) noexcept
+    {
+        node->Next.store(nullptr, std::memory_order_relaxed);
+        auto* previous = Head.exchange(node, std::memory_order_acq_rel);
+        previous->Next.store(node, std::memory_order_release);
+    }
+
+    /// Pop a node from the mailbox.
+    Strand::MessageNode* Strand::Pop() noexcept
+    {
+        auto* tail = Tail;
+        auto* next = tail->Next.load(std::memory_order_acquire);
+        if (tail == &Stub)
+        {
+            if (next == nullptr) return nullptr;
+            Tail = next;
+            tail = next;
+            next = next->Next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            Tail = next;
+            return tail;
+        }
+        if (tail != Head.load(std::memory_order_acquire)) return nullptr;
+        // The tail is the last node, push the stub back so that the tail can be popped.
+        Push(&Stub);
+        next = tail->Next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            Tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    /// Post a message to this strand.
+    void Strand::Post(std::function<void()> message)
+    {
+        auto* node = new MessageNode;
+        node->Message = std::move(message);
+        Push(node);
+        if (PendingCount.fetch_add(1, std::memory_order_acq_rel) == 0)
+        {
+            Schedule();
+        }
+    }
+
+    /// Schedule draining this strand on the executor.
+    void Strand::Schedule()
+    {
+        TargetExecutor.Post([strand = shared_from_this()]{
+            strand->Drain();
+        });
+    }
+
+    /// Run a batch of pending messages.
+    void Strand::Drain()
+    {
+        auto count = std::min(PendingCount.load(std::memory_order_acquire), BatchSize);
+
+        auto* previous_strand = CurrentStrand;
+        CurrentStrand = this;
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            MessageNode* node;
+            // The message is counted, so it is only waiting for its producer to finish linking it.
+            while ((node = Pop()) == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            node->Message();
+            delete node;
+        }
+        CurrentStrand = previous_strand;
+
+        // Reschedule instead of looping, so that other strands get a chance to run on this thread.
+        if (PendingCount.fetch_sub(count, std::memory_order_acq_rel) > count)
+        {
+            Schedule();
+        }
+    }
+
+    /// Check whether the current thread is running a message of this strand.
+    bool Strand::IsRunningInThisThread() const noexcept
+    {
+        return CurrentStrand == this;
+    }
+}
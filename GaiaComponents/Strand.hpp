@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "Executor.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief Strand runs posted messages one by one on an executor, in the order they are posted.
+     * @details Messages are queued in a lock-free multi-producer single-consumer mailbox.
+     *          A strand only occupies a worker thread while it has pending messages,
+     *          so thousands of strands can be multiplexed over the same executor.
+     *          Strands must be owned by std::shared_ptr, because a scheduled strand keeps itself alive
+     *          until its mailbox is drained.
+     */
+    class Strand : public std::enable_shared_from_this<Strand>
+    {
+    private:
+        /// Node of the intrusive mailbox queue.
+        struct MessageNode
+        {
+            /// Next node in the mailbox.
+            std::atomic<MessageNode*> Next {nullptr};
+            /// Message to run.
+            std::function<void()> Message;
+        };
+
+        /// Executor to run messages on.
+        Executor& TargetExecutor;
+        /// Maximum count of messages to run before yielding the worker thread to other strands.
+        const std::size_t BatchSize;
+
+        /// Stub node of the mailbox, which is never used to carry a message.
+        MessageNode Stub;
+        /// Most recently pushed node, it is shared by all producers.
+        std::atomic<MessageNode*> Head {&Stub};
+        /// Next node to pop, it is only accessed by the consumer.
+        MessageNode* Tail {&Stub};
+        /// Count of messages which are posted but not yet run.
+        std::atomic<std::size_t> PendingCount {0};
+
+        /// Push a node into the mailbox.
+        void Push(MessageNode* node) noexcept;
+        /**
+         * @brief Pop a node from the mailbox.
+         * @return The popped node, or nullptr if the next node is still being linked by a producer.
+         */
+        MessageNode* Pop() noexcept;
+        /// Schedule draining this strand on the executor.
+        void Schedule();
+        /// Run a batch of pending messages.
+        void Drain();
+
+    public:
+        /**
+         * @brief Construct a strand on the given executor.
+         * @param executor Executor to run messages on, it must outlive this strand.
+         * @param batch_size Maximum count of messages to run before yielding the worker thread.
+         */
+        explicit Strand(Executor& executor, std::size_t batch_size = 64);
+        /// Destroy all messages which have not been run.
+        ~Strand();
+
+        Strand(const Strand&) = delete;
+        Strand& operator=(const Strand&) = delete;
+
+        /**
+         * @brief Post a message to this strand.
+         * @param message The message to run, it must not throw.
+         * @details This function is lock-free and can be invoked from any thread.
+         */
+        void Post(std::function<void()> message);
+
+        /**
+         * @brief Check whether the current thread is running a message of this strand.
+         * @retval true The caller is a message of this strand.
+         * @retval false The caller is not running on this strand.
+         */
+        [[nodiscard]] bool IsRunningInThisThread() const noexcept;
+    };
+}
@@ -0,0 +1,145 @@
+#include "SystemScheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace Gaia::Components
+{
+    namespace
+    {
+        /// Check whether the two type lists share any type.
+        bool IsOverlapping(const std::vector<std::size_t>& first, const std::vector<std::size_t>& second)
+        {
+            for (auto type : first)
+            {
+                if (std::find(second.begin(), second.end(), type) != second.end()) return true;
+            }
+            return false;
+        }
+    }
+
+    /// Construct a system descriptor.
+    SystemScheduler::SystemDescriptor::SystemDescriptor(std::string name, SystemPhase phase,
+                                                        std::function<void(Component&)> function) :
+        Name(std::move(name)), Phase(phase), Function(std::move(function))
+    {}
+
+    /// Check whether this system conflicts with the given system.
+    bool SystemScheduler::SystemDescriptor::ConflictsWith(const SystemDescriptor& other) const noexcept
+    {
+        return IsOverlapping(WriteTypes, other.WriteTypes) ||
+               IsOverlapping(WriteTypes, other.ReadTypes) ||
+               IsOverlapping(ReadTypes, other.WriteTypes);
+    }
+
+    /// Construct a scheduler.
+    SystemScheduler::SystemScheduler(Executor* executor) : WorkerExecutor(executor)
+    {}
+
+    /// Add a system to this scheduler.
+    SystemScheduler::SystemDescriptor& SystemScheduler::AddSystem(
+            std::string name, SystemPhase phase, std::function<void(Component&)> function)
+    {
+        return *Systems.emplace_back(
+                std::make_unique<SystemDescriptor>(std::move(name), phase, std::move(function)));
+    }
+
+    /// Remove the system with the given name.
+    void SystemScheduler::RemoveSystem(const std::string& name)
+    {
+        Systems.erase(std::remove_if(Systems.begin(), Systems.end(), [&name](const auto& system){
+            return system->Name == name;
+        }), Systems.end());
+    }
+
+    /// Run all systems once, phase by phase.
+    void SystemScheduler::RunFrame(Component& root)
+    {
+        RunPhase(SystemPhase::PreUpdate, root);
+        RunPhase(SystemPhase::Update, root);
+        RunPhase(SystemPhase::PostUpdate, root);
+    }
+
+    /// Run all systems of the given phase.
+    void SystemScheduler::RunPhase(SystemPhase phase, Component& root)
+    {
+        std::vector<SystemDescriptor*> systems;
+        for (auto& system : Systems)
+        {
+            if (system->Phase == phase) systems.push_back(system.get());
+        }
+        if (systems.empty()) return;
+
+        if (WorkerExecutor == nullptr)
+        {
+            for (auto* system : systems)
+            {
+                system->Function(root);
+            }
+            return;
+        }
+
+        // Build the dependency graph: a system depends on every earlier conflicting system of this phase.
+        const auto count = systems.size();
+        std::vector<std::vector<std::size_t>> dependants(count);
+        std::unique_ptr<std::atomic<std::size_t>[]> dependency_counts(new std::atomic<std::size_t>[count]);
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            std::size_t dependency_count = 0;
+            for (std::size_t earlier = 0; earlier < index; ++earlier)
+            {
+                if (systems[index]->ConflictsWith(*systems[earlier]))
+                {
+                    dependants[earlier].push_back(index);
+                    ++dependency_count;
+                }
+            }
+            dependency_counts[index].store(dependency_count);
+        }
+
+        std::mutex finish_mutex;
+        std::condition_variable finish_condition;
+        std::size_t finished_count = 0;
+        std::exception_ptr exception;
+
+        std::function<void(std::size_t)> run_system;
+        run_system = [&](std::size_t index){
+            try
+            {
+                systems[index]->Function(root);
+            }
+            catch (...)
+            {
+                std::unique_lock lock(finish_mutex);
+                if (!exception) exception = std::current_exception();
+            }
+            for (auto dependant : dependants[index])
+            {
+                if (dependency_counts[dependant].fetch_sub(1) == 1)
+                {
+                    WorkerExecutor->Post([&run_system, dependant]{ run_system(dependant); });
+                }
+            }
+            std::unique_lock lock(finish_mutex);
+            if (++finished_count == count) finish_condition.notify_one();
+        };
+
+        // Collect the independent systems before posting any, since running systems decrease the counts.
+        std::vector<std::size_t> independent_systems;
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            if (dependency_counts[index].load() == 0) independent_systems.push_back(index);
+        }
+        for (auto index : independent_systems)
+        {
+            WorkerExecutor->Post([&run_system, index]{ run_system(index); });
+        }
+
+        std::unique_lock lock(finish_mutex);
+        finish_condition.wait(lock, [&]{ return finished_count == count; });
+        if (exception) std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "Component.hpp"
+#include "Executor.hpp"
+
+namespace Gaia::Components
+{
+    /// Phases of a frame, systems in an earlier phase all finish before any system in a later phase starts.
+    enum class SystemPhase
+    {
+        PreUpdate,
+        Update,
+        PostUpdate
+    };
+
+    /**
+     * @brief SystemScheduler runs systems over a component tree once per frame.
+     * @details Systems declare the component types they read and write.
+     *          Within a phase, two systems conflict if one of them writes a type the other one reads or writes,
+     *          conflicting systems run in the order they are added, and the others run concurrently on the executor.
+     */
+    class SystemScheduler
+    {
+    public:
+        /// Declaration of a system and the component types it accesses.
+        class SystemDescriptor
+        {
+            friend class SystemScheduler;
+
+        private:
+            /// Name of the system.
+            std::string Name;
+            /// Phase which this system runs in.
+            SystemPhase Phase;
+            /// Function to run on the root component every frame.
+            std::function<void(Component&)> Function;
+            /// Hash codes of component types which this system reads.
+            std::vector<std::size_t> ReadTypes;
+            /// Hash codes of component types which this system writes.
+            std::vector<std::size_t> WriteTypes;
+
+        public:
+            SystemDescriptor(std::string name, SystemPhase phase, std::function<void(Component&)> function);
+
+            /**
+             * @brief Declare the component types which this system reads.
+             * @tparam ComponentTypes Types of the components to read.
+             * @return This descriptor, for chained declarations.
+             */
+            template <typename... ComponentTypes>
+            SystemDescriptor& Reads()
+            {
+                (ReadTypes.push_back(typeid(ComponentTypes).hash_code()), ...);
+                return *this;
+            }
+
+            /**
+             * @brief Declare the component types which this system writes.
+             * @tparam ComponentTypes Types of the components to write.
+             * @return This descriptor, for chained declarations.
+             */
+            template <typename... ComponentTypes>
+            SystemDescriptor& Writes()
+            {
+                (WriteTypes.push_back(typeid(ComponentTypes).hash_code()), ...);
+                return *this;
+            }
+
+            /**
+             * @brief Check whether this system conflicts with the given system.
+             * @retval true One of the systems writes a type which the other one reads or writes.
+             * @retval false These systems can run concurrently.
+             */
+            [[nodiscard]] bool ConflictsWith(const SystemDescriptor& other) const noexcept;
+
+            /// Get the name of this system.
+            [[nodiscard]] const std::string& GetName() const noexcept
+            {
+                return Name;
+            }
+        };
+
+    private:
+        /// Executor to run systems on, systems run serially in the calling thread if it is null.
+        Executor* WorkerExecutor;
+        /// Registered systems in the order they are added.
+        std::vector<std::unique_ptr<SystemDescriptor>> Systems;
+
+        /**
+         * @brief Run all systems of the given phase.
+         * @param phase The phase to run.
+         * @param root The root component to pass to systems.
+         */
+        void RunPhase(SystemPhase phase, Component& root);
+
+    public:
+        /**
+         * @brief Construct a scheduler.
+         * @param executor Executor to run systems on, or nullptr to run them serially in the calling thread.
+         *                 RunFrame() must not be invoked on a thread of this executor.
+         */
+        explicit SystemScheduler(Executor* executor = nullptr);
+
+        /**
+         * @brief Add a system to this scheduler.
+         * @param name Name of the system.
+         * @param phase Phase which the system runs in.
+         * @param function Function to run on the root component every frame.
+         * @return The descriptor of the system, which is used to declare the types it reads and writes.
+         */
+        SystemDescriptor& AddSystem(std::string name, SystemPhase phase, std::function<void(Component&)> function);
+
+        /**
+         * @brief Remove the system with the given name.
+         * @param name Name of the system to remove.
+         * @details This function will do nothing if no system has the given name.
+         */
+        void RemoveSystem(const std::string& name);
+
+        /**
+         * @brief Run all systems once, phase by phase.
+         * @param root The root component to pass to systems.
+         * @details The first exception thrown by a system is rethrown after its phase completes,
+         *          and the remaining phases are skipped.
+         */
+        void RunFrame(Component& root);
+    };
+}
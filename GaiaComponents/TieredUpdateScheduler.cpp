@@ -0,0 +1,156 @@
+#include "TieredUpdateScheduler.hpp"
+
+#include <algorithm>
+
+namespace Gaia::Components
+{
+    /// Add a tier with the given batch function.
+    std::size_t TieredUpdateScheduler::AddBatchTier(std::uint32_t period, BatchFunction batch)
+    {
+        auto& tier = Tiers.emplace_back();
+        tier.Batch = std::move(batch);
+        tier.Buckets.resize(std::max<std::uint32_t>(period, 1));
+        return Tiers.size() - 1;
+    }
+
+    /// Insert a component into the least populated bucket of a tier.
+    void TieredUpdateScheduler::Insert(ComponentHandle<Component> handle, std::size_t tier_index)
+    {
+        auto& buckets = Tiers[tier_index].Buckets;
+        auto bucket = std::min_element(buckets.begin(), buckets.end(), [](const auto& left, const auto& right){
+            return left.size() < right.size();
+        });
+        Locations[handle] = {tier_index, static_cast<std::size_t>(bucket - buckets.begin()), bucket->size()};
+        bucket->push_back(std::move(handle));
+    }
+
+    /// Remove the empty slots of a bucket and fix up the locations of the moved components.
+    void TieredUpdateScheduler::Compact(std::size_t tier_index, std::size_t bucket_index)
+    {
+        auto& bucket = Tiers[tier_index].Buckets[bucket_index];
+        bucket.erase(std::remove(bucket.begin(), bucket.end(), ComponentHandle<Component>()), bucket.end());
+        for (std::size_t index = 0; index < bucket.size(); ++index)
+        {
+            Locations[bucket[index]].ComponentIndex = index;
+        }
+    }
+
+    /// Unregister the components of a bucket which have been destroyed or detached from their parents.
+    void TieredUpdateScheduler::Prune(std::size_t tier_index, std::size_t bucket_index)
+    {
+        auto& bucket = Tiers[tier_index].Buckets[bucket_index];
+        for (std::size_t index = bucket.size(); index-- > 0;)
+        {
+            auto* component = bucket[index].Get();
+            if (component == nullptr || component->Parent == nullptr)
+            {
+                // Unregistering swaps the last slot into this one, which has already been checked.
+                UnregisterHandle(ComponentHandle<Component>(bucket[index]));
+            }
+        }
+    }
+
+    /// Register a component to a tier.
+    void TieredUpdateScheduler::RegisterHandle(ComponentHandle<Component> handle, std::size_t tier_index)
+    {
+        UnregisterHandle(handle);
+        if (Running)
+        {
+            PendingRegistrations.emplace_back(std::move(handle), tier_index);
+            return;
+        }
+        Insert(std::move(handle), tier_index);
+    }
+
+    /// Unregister a component.
+    void TieredUpdateScheduler::Unregister(Component* component)
+    {
+        if (component == nullptr) return;
+        UnregisterHandle(ComponentHandle<Component>(component));
+    }
+
+    /// Unregister a component by its handle.
+    void TieredUpdateScheduler::UnregisterHandle(const ComponentHandle<Component>& handle)
+    {
+        auto pending = std::remove_if(PendingRegistrations.begin(), PendingRegistrations.end(),
+                                      [&handle](const auto& registration){
+            return registration.first == handle;
+        });
+        PendingRegistrations.erase(pending, PendingRegistrations.end());
+
+        auto finder = Locations.find(handle);
+        if (finder == Locations.end()) return;
+        auto [tier_index, bucket_index, component_index] = finder->second;
+        Locations.erase(finder);
+
+        auto& bucket = Tiers[tier_index].Buckets[bucket_index];
+        if (Running)
+        {
+            // Keep the running bucket in place, the slot is skipped and compacted afterwards.
+            bucket[component_index].Reset();
+            DirtyBuckets.emplace_back(tier_index, bucket_index);
+            return;
+        }
+        if (component_index != bucket.size() - 1)
+        {
+            bucket[component_index] = std::move(bucket.back());
+            Locations[bucket[component_index]].ComponentIndex = component_index;
+        }
+        bucket.pop_back();
+    }
+
+    /// Compact the dirty buckets and insert the pending registrations deferred by the finished bucket.
+    void TieredUpdateScheduler::ApplyDeferredChanges()
+    {
+        std::sort(DirtyBuckets.begin(), DirtyBuckets.end());
+        DirtyBuckets.erase(std::unique(DirtyBuckets.begin(), DirtyBuckets.end()), DirtyBuckets.end());
+        for (auto [dirty_tier, dirty_bucket] : DirtyBuckets)
+        {
+            Compact(dirty_tier, dirty_bucket);
+        }
+        DirtyBuckets.clear();
+        auto registrations = std::move(PendingRegistrations);
+        PendingRegistrations.clear();
+        for (auto& [handle, registration_tier] : registrations)
+        {
+            Insert(std::move(handle), registration_tier);
+        }
+    }
+
+    /// Update the due bucket of every tier and advance to the next frame.
+    std::size_t TieredUpdateScheduler::RunFrame()
+    {
+        std::size_t due_count = 0;
+        for (std::size_t tier_index = 0; tier_index < Tiers.size(); ++tier_index)
+        {
+            auto bucket_index = static_cast<std::size_t>(FrameIndex % Tiers[tier_index].Buckets.size());
+            // Copy the function, an update may add tiers and reallocate them.
+            auto batch = Tiers[tier_index].Batch;
+            Prune(tier_index, bucket_index);
+            auto& bucket = Tiers[tier_index].Buckets[bucket_index];
+            due_count += bucket.size();
+
+            // Finish the bucket even if an update throws, otherwise later changes would be deferred forever.
+            struct RunningScope
+            {
+                TieredUpdateScheduler& Scheduler;
+
+                ~RunningScope()
+                {
+                    Scheduler.Running = false;
+                    Scheduler.ApplyDeferredChanges();
+                }
+            } running_scope {*this};
+            Running = true;
+            batch(bucket.data(), bucket.size());
+        }
+        ++FrameIndex;
+        return due_count;
+    }
+
+    /// Get the count of registered components.
+    std::size_t TieredUpdateScheduler::GetRegisteredCount() const noexcept
+    {
+        return Locations.size() + PendingRegistrations.size();
+    }
+}
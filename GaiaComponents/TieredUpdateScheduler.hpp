@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Component.hpp"
+#include "ComponentHandle.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief TieredUpdateScheduler updates components at different rates with staggered buckets.
+     * @details Every tier has a period in frames, and its components are spread over one bucket per frame
+     *          of the period: a component registers into the least populated bucket of its tier,
+     *          so the load of a tier is flattened across frames.
+     *          Each frame only the due bucket of every tier is invoked, with a statically typed loop
+     *          over a contiguous array, so the per-frame cost is proportional to the due components only.
+     *          Components are kept by handles, so they are followed when pool compaction relocates them.
+     *          Components which have been destroyed or detached from their parents are unregistered
+     *          when their buckets are due, and components in sleeping subtrees are skipped.
+     *          The scheduler must be used from a single thread, but updates may register and unregister
+     *          components; such changes are applied after the running bucket finishes.
+     */
+    class TieredUpdateScheduler
+    {
+    public:
+        /**
+         * @brief Index of a tier returned by AddTier(), which only accepts components of its type.
+         * @tparam ComponentType Type of the components of the tier.
+         */
+        template <typename ComponentType>
+        struct TierIndex
+        {
+            /// Type of the components of the tier.
+            using Type = ComponentType;
+            /// Index of the tier in the order they are added.
+            std::size_t Value;
+        };
+
+        /// Type of batch functions, which update the components behind a contiguous array of handles of a tier.
+        using BatchFunction = std::function<void(const ComponentHandle<Component>* slots, std::size_t count)>;
+
+    private:
+        /// Components updated at the same rate.
+        struct Tier
+        {
+            /// Function which updates the components of a bucket.
+            BatchFunction Batch;
+            /// Buckets of components, one per frame of the period; removed slots are empty until compacted.
+            std::vector<std::vector<ComponentHandle<Component>>> Buckets;
+        };
+
+        /// Position of a registered component.
+        struct Location
+        {
+            /// Index of the tier the component is registered to.
+            std::size_t TierIndex;
+            /// Index of the bucket within the tier, which decides the frames the component is updated in.
+            std::size_t BucketIndex;
+            /// Index of the slot of the component within the bucket.
+            std::size_t ComponentIndex;
+        };
+
+        /// Tiers, in the order they are added.
+        std::vector<Tier> Tiers;
+        /// Positions of the registered components, keyed by their handles.
+        std::unordered_map<ComponentHandle<Component>, Location> Locations;
+        /// Index of the current frame.
+        std::uint64_t FrameIndex {0};
+        /// Whether a bucket is being updated, changes to buckets are deferred until it finishes.
+        bool Running {false};
+        /// Buckets which contain removed slots to compact after the running bucket finishes.
+        std::vector<std::pair<std::size_t, std::size_t>> DirtyBuckets;
+        /// Registrations made while a bucket was running, with their tier indices.
+        std::vector<std::pair<ComponentHandle<Component>, std::size_t>> PendingRegistrations;
+
+        /// Add a tier with the given batch function.
+        std::size_t AddBatchTier(std::uint32_t period, BatchFunction batch);
+        /// Insert a component into the least populated bucket of a tier.
+        void Insert(ComponentHandle<Component> handle, std::size_t tier_index);
+        /// Remove the empty slots of a bucket and fix up the locations of the moved components.
+        void Compact(std::size_t tier_index, std::size_t bucket_index);
+        /// Unregister the components of a bucket which have been destroyed or detached from their parents.
+        void Prune(std::size_t tier_index, std::size_t bucket_index);
+        /// Compact the dirty buckets and insert the pending registrations deferred by the finished bucket.
+        void ApplyDeferredChanges();
+        /// Register a component to a tier, moving it from its previous tier if it has one.
+        void RegisterHandle(ComponentHandle<Component> handle, std::size_t tier_index);
+        /// Unregister a component, nothing happens if it is not registered.
+        void UnregisterHandle(const ComponentHandle<Component>& handle);
+
+    public:
+        /**
+         * @brief Add a tier of components of the given type.
+         * @tparam ComponentType Type of the components which will be registered to this tier.
+         * @param period Count of frames between two updates of a component, 1 updates every frame.
+         * @param update Function which will be invoked with a reference to every due component.
+         * @return Index of the tier, which is used to register components.
+         */
+        template <typename ComponentType, typename UpdateFunction>
+        TierIndex<ComponentType> AddTier(std::uint32_t period, UpdateFunction update)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            return {AddBatchTier(period, [update = std::move(update)](const ComponentHandle<Component>* slots,
+                                                                      std::size_t count) mutable {
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    auto* component = slots[index].Get();
+                    if (component == nullptr || !component->IsAwakeInTree()) continue;
+                    update(*static_cast<ComponentType*>(component));
+                }
+            })};
+        }
+
+        /**
+         * @brief Register a component to a tier, moving it from its previous tier if it has one.
+         * @param component The attached component to update.
+         * @param tier Index of the tier returned by AddTier().
+         * @details The component is unregistered automatically when it is destroyed or detached.
+         */
+        template <typename ComponentType>
+        void Register(typename TierIndex<ComponentType>::Type* component, TierIndex<ComponentType> tier)
+        {
+            RegisterHandle(ComponentHandle<Component>(component), tier.Value);
+        }
+
+        /**
+         * @brief Unregister a component.
+         * @param component The component to stop updating, nothing happens if it is not registered.
+         */
+        void Unregister(Component* component);
+
+        /**
+         * @brief Update the due bucket of every tier and advance to the next frame.
+         * @details If an update throws, the changes made so far during the bucket are still applied,
+         *          the remaining tiers are skipped and the frame does not advance.
+         * @return Count of the live components in the due buckets, including the sleeping ones.
+         */
+        std::size_t RunFrame();
+
+        /// Get the count of registered components, including the destroyed ones which have not been pruned yet.
+        [[nodiscard]] std::size_t GetRegisteredCount() const noexcept;
+    };
+}
@@ -0,0 +1,35 @@
+#include "TreeBuilder.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Gaia::Components
+{
+    /// Create a staging area for the calling thread.
+    TreeBuilder::StagingArea& TreeBuilder::CreateStagingArea()
+    {
+        std::unique_lock lock(AreasMutex);
+        return Areas.emplace_back();
+    }
+
+    /// Attach all staged components to their parents.
+    std::size_t TreeBuilder::Merge()
+    {
+        std::vector<Component::StagedComponent> staged;
+        {
+            std::unique_lock lock(AreasMutex);
+            std::size_t staged_count = 0;
+            for (auto& area : Areas)
+            {
+                staged_count += area.StagedComponents.size();
+            }
+            staged.reserve(staged_count);
+            for (auto& area : Areas)
+            {
+                std::move(area.StagedComponents.begin(), area.StagedComponents.end(), std::back_inserter(staged));
+                area.StagedComponents.clear();
+            }
+        }
+        return Component::MergeStagedComponents(staged);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief TreeBuilder lets multiple threads build disjoint parts of a component tree concurrently.
+     * @details Every loader thread stages components into its own staging area, which takes no lock at all.
+     *          Merge() then attaches everything that has been staged in one bulk step:
+     *          each live parent is locked only once, and the attaching events of the components merged under it
+     *          are triggered before it is unlocked. Observers receive the events of the whole merge in one batch.
+     */
+    class TreeBuilder
+    {
+    public:
+        /**
+         * @brief Components staged by a single thread.
+         * @details A staging area must only be used by one thread at a time, and not while merging.
+         */
+        class StagingArea
+        {
+            friend class TreeBuilder;
+
+        private:
+            /// Staged components, in the order of staging.
+            std::vector<Component::StagedComponent> StagedComponents;
+
+        public:
+            /**
+             * @brief Construct a component and stage it to be attached to the given parent.
+             * @tparam ComponentType Type of the component to stage.
+             * @param parent The parent to attach to, either a live component,
+             *               or a component staged earlier in this staging area.
+             * @param arguments Arguments to pass to the constructor of the component.
+             * @return Pointer to the staged component, which can be used as the parent of further components.
+             * @details No attaching event is triggered until the staged component is merged.
+             *          Staging a component of a type which is already staged under the same parent
+             *          replaces the previous one when merged.
+             */
+            template <typename ComponentType, typename... Arguments>
+            ComponentType* Stage(Component* parent, Arguments&&... arguments)
+            {
+                static_assert(std::is_base_of_v<Component, ComponentType>,
+                              "ComponentType must be derived from Component.");
+                auto instance = std::make_unique<ComponentType>(std::forward<Arguments>(arguments)...);
+                auto* pointer = instance.get();
+                StagedComponents.push_back({parent, typeid(ComponentType).hash_code(), pointer,
+                                            std::move(instance)});
+                return pointer;
+            }
+
+            /// Get the count of components staged in this area.
+            [[nodiscard]] std::size_t GetStagedCount() const noexcept
+            {
+                return StagedComponents.size();
+            }
+        };
+
+    private:
+        /// Mutex for the staging areas collection.
+        std::mutex AreasMutex;
+        /// Staging areas, in the order they were created.
+        std::deque<StagingArea> Areas;
+
+    public:
+        /**
+         * @brief Create a staging area for the calling thread.
+         * @return Reference to the staging area, it stays valid as long as this builder.
+         * @details This function can be invoked from any thread.
+         */
+        StagingArea& CreateStagingArea();
+
+        /**
+         * @brief Attach all staged components to their parents.
+         * @return Count of components which have been attached.
+         * @details Components are merged area by area, in the order the areas were created.
+         *          No staging area may be used while merging; they are empty and reusable afterwards.
+         */
+        std::size_t Merge();
+    };
+}
@@ -0,0 +1,81 @@
+#include "UpdateDispatcher.hpp"
+
+#include <shared_mutex>
+
+namespace Gaia::Components
+{
+    /// Register a batch function for the type with the given hash code.
+    void UpdateDispatcher::RegisterBatch(std::size_t hash, BatchFunction batch)
+    {
+        if (auto finder = GroupIndices.find(hash); finder != GroupIndices.end())
+        {
+            Groups[finder->second].Batch = std::move(batch);
+            return;
+        }
+        GroupIndices.emplace(hash, Groups.size());
+        Groups.push_back({hash, Component::GetTypeSummaryBits(hash), std::move(batch), {}});
+    }
+
+    /// Unregister the batch function of the type with the given hash code.
+    void UpdateDispatcher::UnregisterBatch(std::size_t hash)
+    {
+        auto finder = GroupIndices.find(hash);
+        if (finder == GroupIndices.end()) return;
+
+        Groups.erase(Groups.begin() + static_cast<std::ptrdiff_t>(finder->second));
+        GroupIndices.clear();
+        for (std::size_t index = 0; index < Groups.size(); ++index)
+        {
+            GroupIndices.emplace(Groups[index].Hash, index);
+        }
+    }
+
+    /// Check whether a subtree with the given type summary may contain any registered type.
+    bool UpdateDispatcher::MayContainRegisteredType(std::uint64_t summary) const noexcept
+    {
+        for (const auto& group : Groups)
+        {
+            if ((summary & group.SummaryBits) == group.SummaryBits) return true;
+        }
+        return false;
+    }
+
+    /// Gather the components of registered types under the given component into their groups.
+    void UpdateDispatcher::Gather(Component& component)
+    {
+        if (!MayContainRegisteredType(component.GetSubtreeTypeSummary())) return;
+
+        std::shared_lock lock(component.SubComponentsMutex);
+        for (auto& [hash, sub_component] : component.ActiveSubComponents)
+        {
+            if (auto finder = GroupIndices.find(hash); finder != GroupIndices.end())
+            {
+                Groups[finder->second].Components.push_back(sub_component);
+            }
+            Gather(*sub_component);
+        }
+    }
+
+    /// Update all components of registered types under the given root component.
+    void UpdateDispatcher::Dispatch(Component& root)
+    {
+        for (auto& group : Groups)
+        {
+            group.Components.clear();
+        }
+        Gather(root);
+        for (auto& group : Groups)
+        {
+            if (!group.Components.empty())
+            {
+                group.Batch(group.Components.data(), group.Components.size());
+            }
+        }
+    }
+
+    /// Get the count of registered types.
+    std::size_t UpdateDispatcher::GetTypeCount() const noexcept
+    {
+        return Groups.size();
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "Component.hpp"
+
+namespace Gaia::Components
+{
+    /**
+     * @brief UpdateDispatcher runs updates over a component tree grouped by concrete component type.
+     * @details Instead of invoking a virtual function for every component in the iteration order of the maps,
+     *          components are gathered into one group per registered type and every group is handed to its
+     *          batch function once. The loop inside a batch function is statically typed,
+     *          so the update of a single component can be inlined into it.
+     *          Subtrees which can not contain any registered type are skipped with their type summaries.
+     */
+    class UpdateDispatcher
+    {
+    public:
+        /// Type of batch functions, which update a contiguous group of components of the same type.
+        using BatchFunction = std::function<void(Component* const* components, std::size_t count)>;
+
+    private:
+        /// Components of a registered type and the batch function to update them.
+        struct TypeGroup
+        {
+            /// Hash code of the registered type.
+            std::size_t Hash;
+            /// Bloom filter bits of the registered type in subtree type summaries.
+            std::uint64_t SummaryBits;
+            /// Function which updates the gathered components.
+            BatchFunction Batch;
+            /// Components gathered in the current dispatch, the capacity is reused across dispatches.
+            std::vector<Component*> Components;
+        };
+
+        /// Registered type groups, in the order they are updated.
+        std::vector<TypeGroup> Groups;
+        /// Indices of the type groups in the groups vector, keyed by the hash code of their types.
+        std::unordered_map<std::size_t, std::size_t> GroupIndices;
+
+        /// Register a batch function for the type with the given hash code, replacing the existing one.
+        void RegisterBatch(std::size_t hash, BatchFunction batch);
+        /// Check whether a subtree with the given type summary may contain any registered type.
+        [[nodiscard]] bool MayContainRegisteredType(std::uint64_t summary) const noexcept;
+        /// Gather the components of registered types under the given component into their groups.
+        void Gather(Component& component);
+
+    public:
+        /**
+         * @brief Register the update function of a component type.
+         * @tparam ComponentType Type of the components to update, it must be the type they are added as.
+         * @param update Function which will be invoked with a reference to every component of this type.
+         * @details Registering a type again replaces its update function.
+         *          Types are updated in the order they are first registered.
+         */
+        template <typename ComponentType, typename UpdateFunction>
+        void Register(UpdateFunction update)
+        {
+            static_assert(std::is_base_of_v<Component, ComponentType>,
+                          "ComponentType must be derived from Component.");
+            RegisterBatch(typeid(ComponentType).hash_code(),
+                          [update = std::move(update)](Component* const* components, std::size_t count) mutable {
+                for (std::size_t index = 0; index < count; ++index)
+                {
+                    update(*static_cast<ComponentType*>(components[index]));
+                }
+            });
+        }
+
+        /**
+         * @brief Unregister the update function of a component type.
+         * @tparam ComponentType Type of the components to stop updating.
+         */
+        template <typename ComponentType>
+        void Unregister()
+        {
+            UnregisterBatch(typeid(ComponentType).hash_code());
+        }
+
+        /// Unregister the batch function of the type with the given hash code.
+        void UnregisterBatch(std::size_t hash);
+
+        /**
+         * @brief Update all components of registered types under the given root component.
+         * @param root The root of the tree to update, the root itself is not updated.
+         * @details Components are gathered under the shared locks of their parents before any update is invoked,
+         *          so update functions may read the tree freely,
+         *          but they must not destroy components of the tree until the dispatch has finished.
+         *          Lazy components which have not been constructed are not updated,
+         *          and neither are sleeping components nor their subtrees.
+         */
+        void Dispatch(Component& root);
+
+        /// Get the count of registered types.
+        [[nodiscard]] std::size_t GetTypeCount() const noexcept;
+    };
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+TEST(BudgetSchedulerTest, PriorityAndFairness)
+{
+    BudgetScheduler scheduler;
+    Component first_owner, second_owner;
+
+    std::vector<std::string> order;
+    int first_steps = 0;
+    scheduler.Schedule(&first_owner, [&]{
+        order.emplace_back("First");
+        return ++first_steps < 3 ? WorkStatus::Pending : WorkStatus::Finished;
+    });
+    scheduler.Schedule(&second_owner, [&]{
+        order.emplace_back("Second");
+        return WorkStatus::Finished;
+    });
+    scheduler.Schedule(&second_owner, [&]{
+        order.emplace_back("Urgent");
+        return WorkStatus::Finished;
+    }, 1);
+    EXPECT_EQ(scheduler.GetPendingCount(), 3u);
+
+    EXPECT_EQ(scheduler.RunFrame(std::chrono::seconds(1)), 5u);
+    EXPECT_EQ(order, (std::vector<std::string>{"Urgent", "First", "Second", "First", "First"}));
+    EXPECT_EQ(scheduler.GetPendingCount(), 0u);
+}
+
+TEST(BudgetSchedulerTest, CarryOver)
+{
+    BudgetScheduler scheduler;
+    Component owner;
+
+    int steps = 0;
+    scheduler.Schedule(&owner, [&]{
+        return ++steps < 10 ? WorkStatus::Pending : WorkStatus::Finished;
+    });
+
+    // A zero budget still runs one step per frame.
+    EXPECT_EQ(scheduler.RunFrame(std::chrono::steady_clock::duration::zero()), 1u);
+    EXPECT_EQ(steps, 1);
+    EXPECT_EQ(scheduler.GetPendingCount(), 1u);
+
+    scheduler.Cancel(&owner);
+    EXPECT_EQ(scheduler.GetPendingCount(), 0u);
+    EXPECT_EQ(scheduler.RunFrame(std::chrono::seconds(1)), 0u);
+    EXPECT_EQ(steps, 1);
+}
+
+TEST(BudgetSchedulerTest, CancelDuringStep)
+{
+    BudgetScheduler scheduler;
+    Component owner;
+
+    std::vector<std::string> order;
+    scheduler.Schedule(&owner, [&]{
+        order.emplace_back("Restart");
+        // Work scheduled after cancelling survives, the work queued before it does not.
+        scheduler.Cancel(&owner);
+        scheduler.Schedule(&owner, [&]{
+            order.emplace_back("Restarted");
+            return WorkStatus::Finished;
+        });
+        return WorkStatus::Pending;
+    });
+    scheduler.Schedule(&owner, [&]{
+        order.emplace_back("Dropped");
+        return WorkStatus::Finished;
+    });
+
+    EXPECT_EQ(scheduler.RunFrame(std::chrono::seconds(1)), 2u);
+    EXPECT_EQ(order, (std::vector<std::string>{"Restart", "Restarted"}));
+    EXPECT_EQ(scheduler.GetPendingCount(), 0u);
+}
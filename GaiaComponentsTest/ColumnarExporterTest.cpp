@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+struct SampleTransformValue
+{
+    float X {0.0f};
+    float Y {0.0f};
+    std::int32_t Layer {0};
+};
+
+class SampleVitalityComponent : public Component
+{
+public:
+    double Health {100.0};
+};
+
+/// Read a trivially copyable value from the buffer and advance the offset.
+template <typename ValueType>
+ValueType ReadValue(const std::vector<char>& buffer, std::size_t& offset)
+{
+    ValueType value;
+    std::memcpy(&value, buffer.data() + offset, sizeof(ValueType));
+    offset += sizeof(ValueType);
+    return value;
+}
+
+TEST(ColumnarExporterTest, RecordBatches)
+{
+    constexpr int entity_count = 10;
+
+    // Build a chain of entities, each one carries a transform value and every other one a health component.
+    Component world;
+    std::vector<Component*> entities;
+    Component* parent = &world;
+    for (int index = 0; index < entity_count; ++index)
+    {
+        auto* entity = parent->AddComponent<Component>();
+        entity->AddValue<SampleTransformValue>(SampleTransformValue{static_cast<float>(index), 1.0f, index});
+        if (index % 2 == 0) entity->AddComponent<SampleVitalityComponent>()->Health = index;
+        entities.push_back(entity);
+        parent = entity;
+    }
+
+    ColumnarExporter exporter(4);
+    exporter.Register<SampleTransformValue>("Transform", {"X", "Y", "Layer"},
+                                            &SampleTransformValue::X, &SampleTransformValue::Y,
+                                            &SampleTransformValue::Layer);
+    exporter.Register<SampleVitalityComponent>("Health", {"Health"}, &SampleVitalityComponent::Health);
+    EXPECT_EQ(exporter.GetTypeCount(), 2u);
+
+    auto path = testing::TempDir() + "ColumnarExporterTest.bin";
+    ASSERT_EQ(exporter.Export(world, path), static_cast<std::size_t>(entity_count + entity_count / 2));
+
+    std::ifstream stream(path, std::ios::binary);
+    std::vector<char> buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(buffer.size() % 8, 0u);
+    ASSERT_EQ(std::memcmp(buffer.data(), "GAIACOLS", 8), 0);
+
+    std::size_t offset = 8;
+    EXPECT_EQ(ReadValue<std::uint32_t>(buffer, offset), 1u);
+    ASSERT_EQ(ReadValue<std::uint32_t>(buffer, offset), 2u);
+    for (int schema = 0; schema < 2; ++schema)
+    {
+        offset += 8;
+        auto name_length = ReadValue<std::uint32_t>(buffer, offset);
+        auto column_count = ReadValue<std::uint32_t>(buffer, offset);
+        offset += (name_length + 7) / 8 * 8;
+        for (std::uint32_t column = 0; column < column_count; ++column)
+        {
+            offset += 4;
+            offset += (ReadValue<std::uint32_t>(buffer, offset) + 7) / 8 * 8;
+        }
+    }
+
+    // Collect the transforms and the health values by owner from the record batches.
+    std::map<std::uint64_t, float> transform_x;
+    std::map<std::uint64_t, double> health;
+    std::size_t batch_count = 0;
+    while (true)
+    {
+        ASSERT_EQ(offset % 8, 0u);
+        auto type_id = ReadValue<std::uint64_t>(buffer, offset);
+        auto row_count = ReadValue<std::uint64_t>(buffer, offset);
+        if (type_id == 0) break;
+        ++batch_count;
+        EXPECT_LE(row_count, 4u);
+
+        std::vector<std::uint64_t> owners(row_count);
+        std::memcpy(owners.data(), buffer.data() + offset, row_count * sizeof(std::uint64_t));
+        offset += row_count * sizeof(std::uint64_t);
+        if (type_id == typeid(SampleTransformValue).hash_code())
+        {
+            for (std::size_t row = 0; row < row_count; ++row)
+            {
+                std::memcpy(&transform_x[owners[row]], buffer.data() + offset + row * sizeof(float), sizeof(float));
+            }
+            offset += (row_count * sizeof(float) + 7) / 8 * 8 * 2;
+            offset += (row_count * sizeof(std::int32_t) + 7) / 8 * 8;
+        }
+        else
+        {
+            ASSERT_EQ(type_id, typeid(SampleVitalityComponent).hash_code());
+            for (std::size_t row = 0; row < row_count; ++row)
+            {
+                std::memcpy(&health[owners[row]], buffer.data() + offset + row * sizeof(double), sizeof(double));
+            }
+            offset += row_count * sizeof(double);
+        }
+    }
+    EXPECT_EQ(offset, buffer.size());
+    EXPECT_EQ(batch_count, 5u);
+
+    ASSERT_EQ(transform_x.size(), static_cast<std::size_t>(entity_count));
+    ASSERT_EQ(health.size(), static_cast<std::size_t>(entity_count / 2));
+    for (int index = 0; index < entity_count; ++index)
+    {
+        auto owner = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(entities[index]));
+        EXPECT_FLOAT_EQ(transform_x[owner], static_cast<float>(index));
+        if (index % 2 == 0)
+        {
+            EXPECT_DOUBLE_EQ(health[owner], index);
+        }
+    }
+    std::remove(path.c_str());
+}
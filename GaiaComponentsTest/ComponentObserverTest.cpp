@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <future>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+class SampleObservedComponent : public Component
+{};
+
+class SampleIgnoredComponent : public Component
+{};
+
+class SampleSpawnerComponent : public Component
+{
+protected:
+    void OnAttachedToComponent() override
+    {
+        AddComponent<SampleObservedComponent>();
+        AddComponent<SampleIgnoredComponent>();
+    }
+};
+
+TEST(ComponentObserverTest, SynchronousBatches)
+{
+    Component root;
+    std::vector<std::vector<ComponentEvent>> batches;
+    auto identifier = root.Observe<SampleObservedComponent>([&batches](const auto& events){
+        batches.push_back(events);
+    });
+
+    auto* branch = root.AddComponent<SampleSpawnerComponent>();
+    ASSERT_EQ(batches.size(), 1u);
+    ASSERT_EQ(batches[0].size(), 1u);
+    EXPECT_EQ(batches[0][0].Type, ComponentEventType::Attached);
+    EXPECT_EQ(batches[0][0].Parent, branch);
+    EXPECT_EQ(batches[0][0].Target, branch->GetComponent<SampleObservedComponent>());
+
+    branch->RemoveComponent<SampleIgnoredComponent>();
+    EXPECT_EQ(batches.size(), 1u);
+
+    branch->RemoveComponent<SampleObservedComponent>();
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[1][0].Type, ComponentEventType::Detached);
+
+    root.Unobserve(identifier);
+    branch->AddComponent<SampleObservedComponent>();
+    EXPECT_EQ(batches.size(), 2u);
+}
+
+TEST(ComponentObserverTest, AsynchronousDelivery)
+{
+    Executor executor(1);
+    Component root;
+
+    std::promise<void> blocker;
+    executor.Post([future = blocker.get_future().share()]{ future.wait(); });
+
+    std::promise<std::vector<ComponentEvent>> delivered;
+    root.Observe<SampleObservedComponent>([&delivered](const auto& events){
+        delivered.set_value(events);
+    }, &executor);
+
+    // Both changes happen before the delivery task runs, so they arrive in one batch.
+    root.AddComponent<SampleObservedComponent>();
+    root.RemoveComponent<SampleObservedComponent>();
+    blocker.set_value();
+
+    auto events = delivered.get_future().get();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].Type, ComponentEventType::Attached);
+    EXPECT_EQ(events[1].Type, ComponentEventType::Detached);
+}
+
+class SampleEntityComponent : public Component
+{};
+
+TEST(ComponentObserverTest, NestedComponents)
+{
+    Component root;
+    std::vector<ComponentEvent> events;
+    root.Observe<SampleObservedComponent>([&events](const auto& batch){
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+
+    // A prebuilt entity carries the observed component two levels down.
+    auto entity = std::make_unique<SampleEntityComponent>();
+    auto* body = entity->AddComponent<Component>();
+    auto* observed = body->AddComponent<SampleObservedComponent>();
+    EXPECT_TRUE(events.empty());
+
+    root.AdoptComponent(std::move(entity));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].Type, ComponentEventType::Attached);
+    EXPECT_EQ(events[0].Parent, body);
+    EXPECT_EQ(events[0].Target, observed);
+
+    auto separated = root.SeparateComponent<SampleEntityComponent>();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].Type, ComponentEventType::Detached);
+    EXPECT_EQ(events[1].Target, observed);
+
+    // Changes inside the separated entity are not reported to the former ancestors.
+    body->RemoveComponent<SampleObservedComponent>();
+    EXPECT_EQ(events.size(), 2u);
+
+    body->AddComponent<SampleObservedComponent>();
+    root.AdoptComponent(std::move(separated));
+    root.RemoveComponent<SampleEntityComponent>();
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[2].Type, ComponentEventType::Attached);
+    EXPECT_EQ(events[3].Type, ComponentEventType::Detached);
+}
+
+class SamplePrebuiltComponent : public Component
+{
+public:
+    SamplePrebuiltComponent()
+    {
+        AddComponent<SampleObservedComponent>();
+    }
+};
+
+TEST(ComponentObserverTest, NestedMergedComponents)
+{
+    Component root;
+    std::vector<ComponentEvent> events;
+    root.Observe<SampleObservedComponent>([&events](const auto& batch){
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+
+    // Components built inside a staged component are announced once, and so are staged ones.
+    TreeBuilder builder;
+    auto& area = builder.CreateStagingArea();
+    auto* prebuilt = area.Stage<SamplePrebuiltComponent>(&root);
+    auto* entity = area.Stage<SampleEntityComponent>(&root);
+    auto* staged = area.Stage<SampleObservedComponent>(entity);
+    EXPECT_EQ(builder.Merge(), 3u);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].Target, prebuilt->GetComponent<SampleObservedComponent>());
+    EXPECT_EQ(events[1].Target, staged);
+}
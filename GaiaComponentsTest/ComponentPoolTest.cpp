@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+class SamplePooledComponent : public PooledComponent<SamplePooledComponent>
+{
+public:
+    int SampleValue {0};
+
+    SamplePooledComponent() = default;
+    explicit SamplePooledComponent(int value) : SampleValue(value)
+    {}
+};
+
+class SampleChildComponent : public Component
+{
+public:
+    Component* GetParentComponent()
+    {
+        return GetParent();
+    }
+};
+
+TEST(ComponentPoolTest, Compaction)
+{
+    auto& pool = SamplePooledComponent::GetPool();
+    constexpr int entity_count = 2048;
+
+    std::vector<std::unique_ptr<Component>> entities;
+    for (int index = 0; index < entity_count; ++index)
+    {
+        auto& entity = entities.emplace_back(std::make_unique<Component>());
+        entity->AddComponent<SamplePooledComponent>(index)->AddComponent<SampleChildComponent>();
+    }
+    auto full_page_count = pool.GetPageCount();
+    EXPECT_EQ(pool.GetLiveCount(), static_cast<std::size_t>(entity_count));
+
+    // Keep one instance out of eight, so that every page becomes sparse.
+    for (int index = 0; index < entity_count; ++index)
+    {
+        if (index % 8 != 0) entities[index]->RemoveComponent<SamplePooledComponent>();
+    }
+    EXPECT_EQ(pool.GetPageCount(), full_page_count);
+
+    auto* pinned_component = entities[0]->GetComponent<SamplePooledComponent>();
+    pinned_component->Pin();
+    ComponentHandle<SamplePooledComponent> handle(entities[8]->GetComponent<SamplePooledComponent>());
+    auto* original_component = handle.Get();
+
+    while (!pool.Compact(std::chrono::microseconds(100)))
+    {}
+    EXPECT_LT(pool.GetPageCount(), full_page_count);
+    EXPECT_EQ(pool.GetLiveCount(), static_cast<std::size_t>(entity_count / 8));
+    EXPECT_EQ(entities[0]->GetComponent<SamplePooledComponent>(), pinned_component);
+    pinned_component->Unpin();
+
+    for (int index = 0; index < entity_count; index += 8)
+    {
+        auto* component = entities[index]->GetComponent<SamplePooledComponent>();
+        ASSERT_NE(component, nullptr);
+        EXPECT_EQ(component->SampleValue, index);
+        EXPECT_EQ(component->GetComponent<SampleChildComponent>()->GetParentComponent(), component);
+    }
+    // The handle follows the relocated instance, and is cleared when it is destroyed.
+    EXPECT_NE(handle.Get(), original_component);
+    EXPECT_EQ(handle.Get(), entities[8]->GetComponent<SamplePooledComponent>());
+    EXPECT_EQ(handle->SampleValue, 8);
+    entities[8]->RemoveComponent<SamplePooledComponent>();
+    EXPECT_FALSE(handle);
+
+    entities.clear();
+    EXPECT_EQ(pool.GetPageCount(), 0u);
+}
@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <random>
+#include <thread>
+#include <stdexcept>
 #include "../GaiaComponents/GaiaComponents.hpp"
 
 using namespace Gaia::Components;
@@ -66,4 +71,407 @@ TEST(ComponentTest, Basic)
     EXPECT_EQ(sample_value_component->SampleValue, 6);
     sample_value_component->SampleValue = 7;
     sample_basic_component.AdoptComponent<SampleValueComponent>(std::move(sample_value_component_instance));
-}
\ No newline at end of file
+}
+
+TEST(ComponentTest, SubtreeTypeSummary)
+{
+    Component root;
+    auto* branch = root.AddComponent<SampleBasicComponent>();
+    branch->AddComponent<SampleValueComponent>(2);
+
+    EXPECT_TRUE(root.MayContainInSubtree<SampleValueComponent>());
+    EXPECT_TRUE(root.MayContainInSubtree<SampleBasicComponent>());
+
+    auto found = root.FindComponentsInSubtree<SampleValueComponent>();
+    ASSERT_EQ(found.size(), 1);
+    EXPECT_EQ(found.front()->SampleValue, 2);
+
+    branch->RemoveComponent<SampleValueComponent>();
+    EXPECT_FALSE(root.MayContainInSubtree<SampleValueComponent>());
+    EXPECT_TRUE(root.FindComponentsInSubtree<SampleValueComponent>().empty());
+
+    auto separated = root.SeparateComponent<SampleBasicComponent>();
+    EXPECT_EQ(root.GetSubtreeTypeSummary(), 0);
+    separated->AddComponent<SampleValueComponent>(3);
+    EXPECT_EQ(root.GetSubtreeTypeSummary(), 0);
+    root.AdoptComponent(std::move(separated));
+    EXPECT_EQ(root.FindComponentsInSubtree<SampleValueComponent>().size(), 1);
+}
+
+class SampleAsyncComponent : public Component
+{
+public:
+    std::promise<void> Loading;
+    bool Loaded {false};
+    bool Failing {false};
+
+    explicit SampleAsyncComponent(bool failing = false) : Failing(failing)
+    {}
+
+protected:
+    void OnAttachedAsync() override
+    {
+        Loading.get_future().wait();
+        if (Failing) throw std::runtime_error("Failed to load.");
+        Loaded = true;
+    }
+};
+
+TEST(ComponentTest, AsyncAttaching)
+{
+    Executor executor(1);
+    Component root;
+
+    auto future = root.AddComponentAsync<SampleAsyncComponent>(executor);
+    auto* component = root.GetComponent<SampleAsyncComponent>();
+    ASSERT_NE(component, nullptr);
+    EXPECT_EQ(component->GetState(), ComponentState::Attaching);
+    EXPECT_EQ(root.GetReadyComponent<SampleAsyncComponent>(), nullptr);
+
+    component->Loading.set_value();
+    EXPECT_EQ(future.get(), component);
+    EXPECT_TRUE(component->Loaded);
+    EXPECT_EQ(root.GetReadyComponent<SampleAsyncComponent>(), component);
+
+    auto failing_future = root.AddComponentAsync<SampleAsyncComponent>(executor, true);
+    root.GetComponent<SampleAsyncComponent>()->Loading.set_value();
+    EXPECT_THROW(failing_future.get(), std::runtime_error);
+    EXPECT_EQ(root.GetComponent<SampleAsyncComponent>()->GetState(), ComponentState::Failed);
+    EXPECT_EQ(root.GetReadyComponent<SampleAsyncComponent>(), nullptr);
+    root.RemoveComponent<SampleAsyncComponent>();
+
+    // The continuation runs before the attaching settles, so it posts the removal instead of blocking on it.
+    std::promise<bool> continued;
+    auto* continued_component = root.AddComponentAsync<SampleAsyncComponent>(
+            executor, [&root, &continued, &executor](SampleAsyncComponent* component, std::exception_ptr exception){
+        bool loaded = component->Loaded && !exception;
+        executor.Post([&root, &continued, loaded]{
+            root.RemoveComponent<SampleAsyncComponent>();
+            continued.set_value(loaded);
+        });
+    });
+    EXPECT_EQ(continued_component->GetState(), ComponentState::Attaching);
+    continued_component->Loading.set_value();
+    EXPECT_TRUE(continued.get_future().get());
+    EXPECT_EQ(root.GetComponent<SampleAsyncComponent>(), nullptr);
+
+    // Move assignment keeps the readiness of the assigned component in its parent.
+    auto failed_future = root.AddComponentAsync<SampleAsyncComponent>(executor, true);
+    root.GetComponent<SampleAsyncComponent>()->Loading.set_value();
+    EXPECT_THROW(failed_future.get(), std::runtime_error);
+    auto failed_component = root.SeparateComponent<SampleAsyncComponent>();
+    auto* ready_component = root.AddComponent<SampleAsyncComponent>();
+    *ready_component = std::move(*failed_component);
+    EXPECT_EQ(ready_component->GetState(), ComponentState::Ready);
+    EXPECT_EQ(failed_component->GetState(), ComponentState::Failed);
+    EXPECT_EQ(root.GetReadyComponent<SampleAsyncComponent>(), ready_component);
+}
+
+TEST(ComponentTest, RemoveWhileSettling)
+{
+    Executor executor(1);
+    Component root;
+
+    // The continuation must still see the component while another thread is waiting to remove it.
+    for (int round = 0; round < 200; ++round)
+    {
+        std::atomic<bool> continued_loaded {false};
+        std::promise<void> removed;
+        auto* component = root.AddComponentAsync<SampleAsyncComponent>(
+                executor, [&continued_loaded](SampleAsyncComponent* component, std::exception_ptr){
+            // Give the remover time to run, it must wait for the continuation to return.
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continued_loaded = component->Loaded;
+        });
+        std::thread remover([&root, &removed]{
+            root.RemoveComponent<SampleAsyncComponent>();
+            removed.set_value();
+        });
+        component->Loading.set_value();
+        removed.get_future().wait();
+        remover.join();
+        EXPECT_TRUE(continued_loaded);
+        EXPECT_EQ(root.GetComponent<SampleAsyncComponent>(), nullptr);
+    }
+}
+
+TEST(ComponentTest, LazyComponent)
+{
+    Component root;
+    int construction_count = 0;
+    root.RegisterLazyComponent<SampleValueComponent>([&construction_count]{
+        ++construction_count;
+        return std::make_unique<SampleValueComponent>(5);
+    });
+
+    EXPECT_TRUE(root.HasComponent<SampleValueComponent>());
+    EXPECT_TRUE(root.GetComponents().empty());
+    EXPECT_TRUE(root.MayContainInSubtree<SampleValueComponent>());
+    EXPECT_EQ(construction_count, 0);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> value_sum {0};
+    for (int index = 0; index < 4; ++index)
+    {
+        threads.emplace_back([&root, &value_sum]{
+            value_sum += root.GetComponent<SampleValueComponent>()->SampleValue;
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(construction_count, 1);
+    EXPECT_EQ(value_sum.load(), 20);
+    EXPECT_EQ(root.GetComponents().size(), 1u);
+
+    root.RegisterLazyComponent<SampleBasicComponent>();
+    root.RemoveComponent<SampleBasicComponent>();
+    EXPECT_FALSE(root.HasComponent<SampleBasicComponent>());
+}
+
+class SampleSiblingComponent : public Component
+{
+public:
+    Sibling<SampleValueComponent> Value {this};
+};
+
+TEST(ComponentTest, SiblingReference)
+{
+    Component root;
+    auto* sibling_component = root.AddComponent<SampleSiblingComponent>();
+    EXPECT_FALSE(sibling_component->Value);
+
+    root.AddComponent<SampleValueComponent>(1);
+    ASSERT_TRUE(sibling_component->Value);
+    EXPECT_EQ(sibling_component->Value->SampleValue, 1);
+
+    root.AddComponent<SampleValueComponent>(2);
+    EXPECT_EQ(sibling_component->Value->SampleValue, 2);
+
+    auto separated = root.SeparateComponent<SampleValueComponent>();
+    EXPECT_FALSE(sibling_component->Value);
+
+    auto separated_sibling = root.SeparateComponent<SampleSiblingComponent>();
+    separated_sibling->AddComponent<SampleValueComponent>(3);
+    EXPECT_FALSE(separated_sibling->Value);
+    auto* adopted_sibling = separated->AdoptComponent(std::move(separated_sibling));
+    EXPECT_FALSE(adopted_sibling->Value);
+    separated->AddComponent<SampleValueComponent>(4);
+    EXPECT_EQ(adopted_sibling->Value->SampleValue, 4);
+
+    // A moved reference follows its new owner.
+    static_assert(std::is_nothrow_move_constructible_v<SampleSiblingComponent>);
+    auto original_sibling = separated->SeparateComponent<SampleSiblingComponent>();
+    auto* moved_sibling = separated->AdoptComponent(
+            std::make_unique<SampleSiblingComponent>(std::move(*original_sibling)));
+    EXPECT_EQ(moved_sibling->Value->SampleValue, 4);
+}
+
+template <int Index>
+class SampleIndexedComponent : public Component
+{};
+
+template <int... Indices>
+void AddSampleIndexedComponents(Component& parent, std::integer_sequence<int, Indices...>)
+{
+    (parent.AddComponent<SampleIndexedComponent<Indices>>(), ...);
+}
+
+TEST(ComponentTest, HotSet)
+{
+    Component root;
+    AddSampleIndexedComponents(root, std::make_integer_sequence<int, 16>());
+
+    auto* hot_component = root.GetComponent<SampleIndexedComponent<7>>();
+    for (int round = 0; round < 1000; ++round)
+    {
+        EXPECT_EQ(root.GetComponent<SampleIndexedComponent<7>>(), hot_component);
+        EXPECT_NE(root.GetComponent<SampleIndexedComponent<1>>(), nullptr);
+    }
+
+    // Replaced and removed components must not be returned from the hot set.
+    auto* replaced_component = root.AddComponent<SampleIndexedComponent<7>>();
+    EXPECT_NE(replaced_component, hot_component);
+    EXPECT_EQ(root.GetComponent<SampleIndexedComponent<7>>(), replaced_component);
+    root.RemoveComponent<SampleIndexedComponent<7>>();
+    EXPECT_EQ(root.GetComponent<SampleIndexedComponent<7>>(), nullptr);
+}
+
+TEST(ComponentTest, BatchLookup)
+{
+    constexpr std::size_t parent_count = 100000;
+
+    std::vector<std::unique_ptr<Component>> parents_storage;
+    std::vector<Component*> parents;
+    for (std::size_t index = 0; index < parent_count; ++index)
+    {
+        auto& parent = parents_storage.emplace_back(std::make_unique<Component>());
+        parent->AddComponent<SampleIndexedComponent<0>>();
+        if (index % 3 != 0) parent->AddComponent<SampleValueComponent>(static_cast<int>(index));
+        parents.push_back(parent.get());
+    }
+    std::shuffle(parents.begin(), parents.end(), std::mt19937(0));
+
+    std::vector<SampleValueComponent*> batch_results(parent_count);
+    auto batch_begin = std::chrono::steady_clock::now();
+    Component::GetComponentBatch(parents.data(), parent_count, batch_results.data());
+    auto batch_end = std::chrono::steady_clock::now();
+
+    std::vector<SampleValueComponent*> naive_results(parent_count);
+    auto naive_begin = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < parent_count; ++index)
+    {
+        naive_results[index] = parents[index]->GetComponent<SampleValueComponent>();
+    }
+    auto naive_end = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(naive_results, batch_results);
+    std::cout << "Naive lookup: " << std::chrono::duration<double, std::micro>(naive_end - naive_begin).count()
+              << "us, batch lookup: " << std::chrono::duration<double, std::micro>(batch_end - batch_begin).count()
+              << "us" << std::endl;
+}
+
+class SampleParentComponent : public Component
+{
+public:
+    Component* GetOwner()
+    {
+        return GetParent();
+    }
+};
+
+class SampleDetachingComponent : public Component
+{
+public:
+    bool* DetachedReadable {nullptr};
+
+    void OnDetachedFromComponent() override
+    {
+        // Reading the parent while it is still locked would deadlock.
+        if (DetachedReadable != nullptr)
+        {
+            *DetachedReadable = GetParent()->GetComponent<SampleDetachingComponent>() == nullptr;
+        }
+    }
+};
+
+TEST(ComponentTest, MoveComponent)
+{
+    static_assert(std::is_nothrow_move_constructible_v<SampleValueComponent>);
+    static_assert(std::is_move_assignable_v<SampleValueComponent>);
+
+    std::vector<SampleValueComponent> entities;
+    for (int index = 0; index < 100; ++index)
+    {
+        auto& entity = entities.emplace_back(index);
+        entity.AddComponent<SampleParentComponent>();
+    }
+    for (auto& entity : entities)
+    {
+        auto* parent_component = entity.GetComponent<SampleParentComponent>();
+        ASSERT_NE(parent_component, nullptr);
+        EXPECT_EQ(parent_component->GetOwner(), &entity);
+        EXPECT_TRUE(entity.MayContainInSubtree<SampleParentComponent>());
+    }
+
+    Component root;
+    auto* target = root.AddComponent<SampleValueComponent>();
+    target->AddComponent<SampleBasicComponent>();
+    auto* moved_component = entities.back().GetComponent<SampleParentComponent>();
+    *target = std::move(entities.back());
+    EXPECT_EQ(target->GetComponent<SampleBasicComponent>(), nullptr);
+    EXPECT_EQ(target->GetComponent<SampleParentComponent>(), moved_component);
+    EXPECT_EQ(moved_component->GetOwner(), target);
+    EXPECT_EQ(entities.back().GetComponent<SampleParentComponent>(), nullptr);
+    EXPECT_EQ(root.FindComponentsInSubtree<SampleParentComponent>().size(), 1u);
+    EXPECT_TRUE(root.FindComponentsInSubtree<SampleBasicComponent>().empty());
+
+    bool detached_readable = false;
+    target->AddComponent<SampleDetachingComponent>()->DetachedReadable = &detached_readable;
+    *target = SampleValueComponent();
+    EXPECT_TRUE(detached_readable);
+}
+
+struct SampleLargeValue
+{
+    double Values[8] {};
+    std::string Name;
+};
+
+TEST(ComponentTest, ValueComponent)
+{
+    EXPECT_LE(sizeof(ComponentValue), 4 * sizeof(void*));
+
+    Component entity;
+    EXPECT_EQ(entity.GetValue<int>(), nullptr);
+
+    *entity.AddValue<int>(3) += 1;
+    EXPECT_TRUE(entity.HasValue<int>());
+    EXPECT_EQ(*entity.GetValue<int>(), 4);
+
+    entity.AddValue<SampleLargeValue>()->Name = "Large";
+    entity.AddValue<std::unique_ptr<int>>(std::make_unique<int>(5));
+    EXPECT_EQ(entity.GetValue<SampleLargeValue>()->Name, "Large");
+    EXPECT_EQ(**entity.GetValue<std::unique_ptr<int>>(), 5);
+
+    entity.AddValue<int>(7);
+    EXPECT_EQ(*entity.GetValue<int>(), 7);
+
+    EXPECT_TRUE(entity.RemoveValue<int>());
+    EXPECT_FALSE(entity.RemoveValue<int>());
+    EXPECT_FALSE(entity.HasValue<int>());
+    EXPECT_EQ(entity.GetValue<SampleLargeValue>()->Name, "Large");
+    EXPECT_EQ(**entity.GetValue<std::unique_ptr<int>>(), 5);
+
+    Component moved_entity(std::move(entity));
+    EXPECT_FALSE(entity.HasValue<SampleLargeValue>());
+    EXPECT_EQ(moved_entity.GetValue<SampleLargeValue>()->Name, "Large");
+}
+
+TEST(ComponentTest, SleepingComponent)
+{
+    Component root;
+    AddSampleIndexedComponents(root, std::make_integer_sequence<int, 4>());
+    auto* sleeper = root.GetComponent<SampleIndexedComponent<1>>();
+    sleeper->AddComponent<SampleValueComponent>(1);
+    root.GetComponent<SampleIndexedComponent<2>>()->AddComponent<SampleValueComponent>(2);
+    EXPECT_EQ(root.GetActiveComponents().size(), 4u);
+
+    sleeper->Sleep();
+    EXPECT_TRUE(sleeper->IsAsleep());
+    EXPECT_EQ(root.GetActiveComponents().size(), 3u);
+    // A sleeping component is still attached, but its subtree is skipped by traversals.
+    EXPECT_EQ(root.GetComponent<SampleIndexedComponent<1>>(), sleeper);
+    auto values = root.FindComponentsInSubtree<SampleValueComponent>();
+    ASSERT_EQ(values.size(), 1u);
+    EXPECT_EQ(values[0]->SampleValue, 2);
+
+    UpdateDispatcher dispatcher;
+    int updated_sum = 0;
+    dispatcher.Register<SampleValueComponent>([&updated_sum](SampleValueComponent& component){
+        updated_sum += component.SampleValue;
+    });
+    dispatcher.Dispatch(root);
+    EXPECT_EQ(updated_sum, 2);
+
+    // Removing an active component must keep the indices of the others consistent.
+    root.RemoveComponent<SampleIndexedComponent<0>>();
+    EXPECT_EQ(root.GetActiveComponents().size(), 2u);
+    sleeper->Wake();
+    EXPECT_FALSE(sleeper->IsAsleep());
+    EXPECT_EQ(root.GetActiveComponents().size(), 3u);
+    root.GetComponent<SampleIndexedComponent<3>>()->Sleep();
+    std::vector<Component*> active_components;
+    root.ForEachActiveComponent([&active_components](Component* component){
+        active_components.push_back(component);
+    });
+    std::sort(active_components.begin(), active_components.end());
+    std::vector<Component*> expected_components {sleeper, root.GetComponent<SampleIndexedComponent<2>>()};
+    std::sort(expected_components.begin(), expected_components.end());
+    EXPECT_EQ(active_components, expected_components);
+
+    updated_sum = 0;
+    dispatcher.Dispatch(root);
+    EXPECT_EQ(updated_sum, 3);
+}
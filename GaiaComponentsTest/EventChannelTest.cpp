@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+struct SampleDamageEvent
+{
+    int Amount;
+};
+
+class SampleHealthComponent : public Component, public EventHandler<SampleDamageEvent>
+{
+public:
+    int Health {100};
+
+    void OnEvent(const SampleDamageEvent& event) override
+    {
+        Health -= event.Amount;
+    }
+};
+
+class SampleWeaponComponent : public Component
+{
+public:
+    EventChannel<SampleDamageEvent> DamageChannel;
+
+protected:
+    void OnAttachedToComponent() override
+    {
+        DamageChannel.Bind(GetParent());
+    }
+};
+
+TEST(EventChannelTest, SiblingScope)
+{
+    Component entity;
+    auto* weapon = entity.AddComponent<SampleWeaponComponent>();
+    EXPECT_EQ(weapon->DamageChannel.GetHandlerCount(), 0u);
+
+    auto* health = entity.AddComponent<SampleHealthComponent>();
+    weapon->DamageChannel.Publish({10});
+    EXPECT_EQ(health->Health, 90);
+    EXPECT_EQ(weapon->DamageChannel.GetHandlerCount(), 1u);
+
+    auto* replaced_health = entity.AddComponent<SampleHealthComponent>();
+    weapon->DamageChannel.Publish({5});
+    EXPECT_EQ(replaced_health->Health, 95);
+
+    entity.RemoveComponent<SampleHealthComponent>();
+    EXPECT_EQ(weapon->DamageChannel.GetHandlerCount(), 0u);
+}
+
+TEST(EventChannelTest, SubtreeScope)
+{
+    Component world;
+    auto* first = world.AddComponent<SampleWeaponComponent>();
+    auto* health = first->AddComponent<SampleHealthComponent>();
+
+    EventChannel<SampleDamageEvent> siblings_channel(&world);
+    EventChannel<SampleDamageEvent> subtree_channel(&world, EventScope::Subtree);
+    siblings_channel.Publish({1});
+    EXPECT_EQ(health->Health, 100);
+    subtree_channel.Publish({1});
+    EXPECT_EQ(health->Health, 99);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include <future>
+#include <thread>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+class SampleCounterComponent : public Component
+{
+public:
+    int Counter {0};
+};
+
+TEST(StrandTest, SerializedMessages)
+{
+    Executor executor(4);
+    auto strand = std::make_shared<Strand>(executor);
+
+    Component root;
+    root.BindStrand(strand);
+    auto* counter = root.AddComponent<SampleCounterComponent>();
+    EXPECT_EQ(counter->GetStrand(), strand);
+
+    constexpr int thread_count = 4;
+    constexpr int message_count = 10000;
+
+    std::vector<std::thread> producers;
+    for (int thread_index = 0; thread_index < thread_count; ++thread_index)
+    {
+        producers.emplace_back([counter]{
+            for (int index = 0; index < message_count; ++index)
+            {
+                counter->Post([counter]{ ++counter->Counter; });
+            }
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    std::promise<int> result;
+    counter->Post([counter, &result, &strand]{
+        EXPECT_TRUE(strand->IsRunningInThisThread());
+        result.set_value(counter->Counter);
+    });
+    EXPECT_EQ(result.get_future().get(), thread_count * message_count);
+    EXPECT_FALSE(strand->IsRunningInThisThread());
+}
+
+TEST(StrandTest, Unbound)
+{
+    Component root;
+    EXPECT_EQ(root.GetStrand(), nullptr);
+    EXPECT_FALSE(root.Post([]{}));
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+class SamplePositionComponent : public Component
+{
+public:
+    int Position {0};
+};
+
+class SampleVelocityComponent : public Component
+{
+public:
+    int Velocity {0};
+};
+
+TEST(SystemSchedulerTest, Ordering)
+{
+    Executor executor(4);
+    SystemScheduler scheduler(&executor);
+
+    Component root;
+    root.AddComponent<SamplePositionComponent>();
+    root.AddComponent<SampleVelocityComponent>();
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name){
+        std::unique_lock lock(order_mutex);
+        order.push_back(name);
+    };
+
+    scheduler.AddSystem("Integrate", SystemPhase::Update, [&](Component& component){
+        component.GetComponent<SamplePositionComponent>()->Position +=
+                component.GetComponent<SampleVelocityComponent>()->Velocity;
+        record("Integrate");
+    }).Reads<SampleVelocityComponent>().Writes<SamplePositionComponent>();
+    scheduler.AddSystem("Accelerate", SystemPhase::PreUpdate, [&](Component& component){
+        component.GetComponent<SampleVelocityComponent>()->Velocity += 1;
+        record("Accelerate");
+    }).Writes<SampleVelocityComponent>();
+    scheduler.AddSystem("Report", SystemPhase::Update, [&](Component&){
+        record("Report");
+    }).Reads<SamplePositionComponent>();
+
+    scheduler.RunFrame(root);
+    scheduler.RunFrame(root);
+
+    EXPECT_EQ(root.GetComponent<SamplePositionComponent>()->Position, 3);
+    ASSERT_EQ(order.size(), 6u);
+    EXPECT_EQ(order[0], "Accelerate");
+    EXPECT_EQ(order[1], "Integrate");
+    EXPECT_EQ(order[2], "Report");
+
+    scheduler.RemoveSystem("Report");
+    scheduler.RunFrame(root);
+    EXPECT_EQ(order.size(), 8u);
+}
+
+TEST(SystemSchedulerTest, Concurrency)
+{
+    Executor executor(4);
+    SystemScheduler scheduler(&executor);
+    Component root;
+
+    // Both readers only return early if they meet, which requires them to run at the same time.
+    std::atomic<int> arrived {0};
+    std::atomic<int> met {0};
+    auto meet = [&](Component&){
+        ++arrived;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (arrived.load() < 2 && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        if (arrived.load() >= 2) ++met;
+    };
+    scheduler.AddSystem("FirstMeeting", SystemPhase::PreUpdate, meet).Reads<SamplePositionComponent>();
+    scheduler.AddSystem("SecondMeeting", SystemPhase::PreUpdate, meet).Reads<SamplePositionComponent>();
+
+    std::atomic<int> count {0};
+    for (int index = 0; index < 16; ++index)
+    {
+        scheduler.AddSystem("Reader" + std::to_string(index), SystemPhase::Update, [&](Component&){
+            ++count;
+        }).Reads<SamplePositionComponent>();
+    }
+    scheduler.AddSystem("Failure", SystemPhase::Update, [](Component&){
+        throw std::runtime_error("Failure");
+    });
+
+    EXPECT_THROW(scheduler.RunFrame(root), std::runtime_error);
+    EXPECT_EQ(met.load(), 2);
+    EXPECT_EQ(count.load(), 16);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+class SampleTieredComponent : public Component
+{
+public:
+    int UpdateCount {0};
+};
+
+class SamplePooledTieredComponent : public PooledComponent<SamplePooledTieredComponent>
+{
+public:
+    int UpdateCount {0};
+};
+
+TEST(TieredUpdateSchedulerTest, StaggeredBuckets)
+{
+    std::vector<std::unique_ptr<Component>> entities;
+    std::vector<SampleTieredComponent*> components;
+    for (int index = 0; index < 7; ++index)
+    {
+        auto& entity = entities.emplace_back(std::make_unique<Component>());
+        components.push_back(entity->AddComponent<SampleTieredComponent>());
+    }
+
+    TieredUpdateScheduler scheduler;
+    auto fast_tier = scheduler.AddTier<SampleTieredComponent>(1, [](auto& component){
+        ++component.UpdateCount;
+    });
+    auto slow_tier = scheduler.AddTier<SampleTieredComponent>(3, [](auto& component){
+        ++component.UpdateCount;
+    });
+    scheduler.Register(components[0], fast_tier);
+    for (std::size_t index = 1; index < components.size(); ++index)
+    {
+        scheduler.Register(components[index], slow_tier);
+    }
+    EXPECT_EQ(scheduler.GetRegisteredCount(), 7u);
+
+    // The slow tier is spread evenly, two of its components are due every frame.
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        EXPECT_EQ(scheduler.RunFrame(), 3u);
+    }
+    EXPECT_EQ(components[0]->UpdateCount, 3);
+    for (std::size_t index = 1; index < components.size(); ++index)
+    {
+        EXPECT_EQ(components[index]->UpdateCount, 1);
+    }
+
+    // Sleeping components keep their buckets but are not updated.
+    components[1]->Sleep();
+    scheduler.Unregister(components[2]);
+    EXPECT_EQ(scheduler.GetRegisteredCount(), 6u);
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        scheduler.RunFrame();
+    }
+    EXPECT_EQ(components[1]->UpdateCount, 1);
+    EXPECT_EQ(components[2]->UpdateCount, 1);
+    EXPECT_EQ(components[3]->UpdateCount, 2);
+}
+
+TEST(TieredUpdateSchedulerTest, ChangesDuringUpdate)
+{
+    Component first_entity, second_entity;
+    auto* first = first_entity.AddComponent<SampleTieredComponent>();
+    auto* second = second_entity.AddComponent<SampleTieredComponent>();
+
+    TieredUpdateScheduler scheduler;
+    TieredUpdateScheduler::TierIndex<SampleTieredComponent> tier {0};
+    tier = scheduler.AddTier<SampleTieredComponent>(1, [&](auto& component){
+        ++component.UpdateCount;
+        // The first component hands its slot over to the second one.
+        if (&component == first)
+        {
+            scheduler.Unregister(first);
+            scheduler.Register(second, tier);
+        }
+    });
+    scheduler.Register(first, tier);
+
+    EXPECT_EQ(scheduler.RunFrame(), 1u);
+    EXPECT_EQ(scheduler.GetRegisteredCount(), 1u);
+    EXPECT_EQ(scheduler.RunFrame(), 1u);
+    EXPECT_EQ(first->UpdateCount, 1);
+    EXPECT_EQ(second->UpdateCount, 1);
+}
+
+TEST(TieredUpdateSchedulerTest, ThrowingUpdate)
+{
+    Component first_entity, second_entity;
+    auto* first = first_entity.AddComponent<SampleTieredComponent>();
+    auto* second = second_entity.AddComponent<SampleTieredComponent>();
+
+    TieredUpdateScheduler scheduler;
+    TieredUpdateScheduler::TierIndex<SampleTieredComponent> tier {0};
+    tier = scheduler.AddTier<SampleTieredComponent>(1, [&](auto& component){
+        ++component.UpdateCount;
+        if (&component == first && component.UpdateCount == 1)
+        {
+            scheduler.Unregister(first);
+            scheduler.Register(second, tier);
+            throw std::runtime_error("Update failed.");
+        }
+    });
+    scheduler.Register(first, tier);
+
+    // The changes made before the exception are applied, and later changes are not deferred.
+    EXPECT_THROW(scheduler.RunFrame(), std::runtime_error);
+    EXPECT_EQ(scheduler.GetRegisteredCount(), 1u);
+    scheduler.Register(first, tier);
+    EXPECT_EQ(scheduler.RunFrame(), 2u);
+    EXPECT_EQ(first->UpdateCount, 2);
+    EXPECT_EQ(second->UpdateCount, 1);
+}
+
+TEST(TieredUpdateSchedulerTest, FollowTree)
+{
+    std::vector<std::unique_ptr<Component>> entities;
+    std::vector<SampleTieredComponent*> components;
+    for (int index = 0; index < 4; ++index)
+    {
+        auto& entity = entities.emplace_back(std::make_unique<Component>());
+        components.push_back(entity->AddComponent<Component>()->AddComponent<SampleTieredComponent>());
+    }
+
+    TieredUpdateScheduler scheduler;
+    auto tier = scheduler.AddTier<SampleTieredComponent>(1, [](auto& component){
+        ++component.UpdateCount;
+    });
+    for (auto* component : components)
+    {
+        scheduler.Register(component, tier);
+    }
+
+    // A sleeping ancestor stops the updates of its whole subtree.
+    entities[0]->GetComponent<Component>()->Sleep();
+    // Removed and separated components are unregistered without being updated.
+    entities[1]->GetComponent<Component>()->RemoveComponent<SampleTieredComponent>();
+    auto separated = entities[2]->GetComponent<Component>()->SeparateComponent<SampleTieredComponent>();
+    EXPECT_EQ(scheduler.RunFrame(), 2u);
+    EXPECT_EQ(scheduler.GetRegisteredCount(), 2u);
+    EXPECT_EQ(components[0]->UpdateCount, 0);
+    EXPECT_EQ(separated->UpdateCount, 0);
+    EXPECT_EQ(components[3]->UpdateCount, 1);
+
+    entities[0]->GetComponent<Component>()->Wake();
+    scheduler.RunFrame();
+    EXPECT_EQ(components[0]->UpdateCount, 1);
+}
+
+TEST(TieredUpdateSchedulerTest, FollowRelocation)
+{
+    auto& pool = SamplePooledTieredComponent::GetPool();
+    constexpr int entity_count = 512;
+
+    std::vector<std::unique_ptr<Component>> entities;
+    for (int index = 0; index < entity_count; ++index)
+    {
+        entities.emplace_back(std::make_unique<Component>())->AddComponent<SamplePooledTieredComponent>();
+    }
+    for (int index = 0; index < entity_count; ++index)
+    {
+        if (index % 8 != 0) entities[index]->RemoveComponent<SamplePooledTieredComponent>();
+    }
+
+    TieredUpdateScheduler scheduler;
+    auto tier = scheduler.AddTier<SamplePooledTieredComponent>(1, [](auto& component){
+        ++component.UpdateCount;
+    });
+    std::vector<SamplePooledTieredComponent*> original_components;
+    for (int index = 0; index < entity_count; index += 8)
+    {
+        original_components.push_back(entities[index]->GetComponent<SamplePooledTieredComponent>());
+        scheduler.Register(original_components.back(), tier);
+    }
+    while (!pool.Compact(std::chrono::microseconds(100)))
+    {}
+    SamplePooledTieredComponent* relocated_component = nullptr;
+    for (int index = 0; index < entity_count; index += 8)
+    {
+        auto* component = entities[index]->GetComponent<SamplePooledTieredComponent>();
+        if (component != original_components[index / 8]) relocated_component = component;
+    }
+    ASSERT_NE(relocated_component, nullptr);
+
+    // The scheduler updates the relocated instances, and unregisters them by their new addresses.
+    EXPECT_EQ(scheduler.RunFrame(), static_cast<std::size_t>(entity_count / 8));
+    for (int index = 0; index < entity_count; index += 8)
+    {
+        EXPECT_EQ(entities[index]->GetComponent<SamplePooledTieredComponent>()->UpdateCount, 1);
+    }
+    scheduler.Unregister(relocated_component);
+    EXPECT_EQ(scheduler.GetRegisteredCount(), static_cast<std::size_t>(entity_count / 8 - 1));
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+template <int Index>
+class SampleNodeComponent : public Component
+{
+public:
+    bool Attached {false};
+    std::size_t AttachedChildCount {0};
+
+protected:
+    void OnAttachedToComponent() override
+    {
+        // The whole staged subtree must be linked when the events are triggered.
+        // The parent may still be locked by the merge, as it is by AddComponent(), so it is not accessed.
+        Attached = GetParent() != nullptr;
+        AttachedChildCount = GetComponents().size();
+    }
+};
+
+TEST(TreeBuilderTest, ConcurrentStaging)
+{
+    constexpr int thread_count = 4;
+    constexpr int depth_count = 32;
+
+    std::vector<std::unique_ptr<Component>> live_parents;
+    for (int index = 0; index < thread_count; ++index)
+    {
+        live_parents.push_back(std::make_unique<Component>());
+    }
+
+    std::vector<std::size_t> batch_sizes;
+    live_parents[0]->Observe<SampleNodeComponent<1>>([&batch_sizes](const auto& events){
+        batch_sizes.push_back(events.size());
+    });
+
+    TreeBuilder builder;
+    std::vector<std::thread> loaders;
+    for (int thread_index = 0; thread_index < thread_count; ++thread_index)
+    {
+        loaders.emplace_back([&builder, parent = live_parents[thread_index].get()]{
+            auto& area = builder.CreateStagingArea();
+            auto* node = area.Stage<SampleNodeComponent<0>>(parent);
+            for (int index = 0; index < depth_count; ++index)
+            {
+                node = area.Stage<SampleNodeComponent<0>>(node);
+                area.Stage<SampleNodeComponent<1>>(node);
+            }
+        });
+    }
+    for (auto& loader : loaders)
+    {
+        loader.join();
+    }
+
+    EXPECT_EQ(builder.Merge(), static_cast<std::size_t>(thread_count * (1 + 2 * depth_count)));
+    for (auto& parent : live_parents)
+    {
+        Component* node = parent.get();
+        for (int depth = 0; depth <= depth_count; ++depth)
+        {
+            auto* child = node->GetComponent<SampleNodeComponent<0>>();
+            ASSERT_NE(child, nullptr);
+            EXPECT_TRUE(child->Attached);
+            EXPECT_EQ(child->AttachedChildCount, depth == 0 || depth == depth_count ? 1u : 2u);
+            if (depth > 0)
+            {
+                auto* leaf = child->GetComponent<SampleNodeComponent<1>>();
+                ASSERT_NE(leaf, nullptr);
+                EXPECT_TRUE(leaf->Attached);
+            }
+            node = child;
+        }
+        EXPECT_TRUE(parent->MayContainInSubtree<SampleNodeComponent<1>>());
+        EXPECT_EQ(parent->FindComponentsInSubtree<SampleNodeComponent<1>>().size(),
+                  static_cast<std::size_t>(depth_count));
+    }
+    // All attaching events of the merge are delivered to the observer in one batch.
+    EXPECT_EQ(batch_sizes, std::vector<std::size_t>{static_cast<std::size_t>(depth_count)});
+    EXPECT_EQ(builder.Merge(), 0u);
+}
+
+TEST(TreeBuilderTest, Replacement)
+{
+    Component root;
+    TreeBuilder builder;
+    auto& area = builder.CreateStagingArea();
+    auto* existing = area.Stage<SampleNodeComponent<0>>(&root);
+    EXPECT_EQ(builder.Merge(), 1u);
+    EXPECT_TRUE(existing->Attached);
+
+    int detached_count = 0;
+    root.Observe<SampleNodeComponent<0>>([&detached_count](const auto& events){
+        for (const auto& event : events)
+        {
+            if (event.Type == ComponentEventType::Detached) ++detached_count;
+        }
+    });
+
+    auto* discarded = area.Stage<SampleNodeComponent<0>>(&root);
+    area.Stage<SampleNodeComponent<1>>(discarded);
+    auto* replacement = area.Stage<SampleNodeComponent<0>>(&root);
+    EXPECT_EQ(area.GetStagedCount(), 3u);
+
+    EXPECT_EQ(builder.Merge(), 1u);
+    EXPECT_EQ(area.GetStagedCount(), 0u);
+    EXPECT_EQ(detached_count, 1);
+    EXPECT_NE(root.GetComponent<SampleNodeComponent<0>>(), existing);
+    EXPECT_EQ(root.GetComponent<SampleNodeComponent<0>>(), replacement);
+    EXPECT_TRUE(replacement->Attached);
+    EXPECT_FALSE(root.MayContainInSubtree<SampleNodeComponent<1>>());
+}
+
+class SampleGuardedComponent : public Component
+{
+public:
+    std::atomic<bool>* OutOfOrder;
+    bool Attached {false};
+
+    explicit SampleGuardedComponent(std::atomic<bool>* out_of_order) : OutOfOrder(out_of_order)
+    {}
+
+protected:
+    void OnAttachedToComponent() override
+    {
+        // Give a concurrent removal time to run, it must wait until the events have been triggered.
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        Attached = true;
+    }
+
+    void OnDetachedFromComponent() override
+    {
+        if (!Attached) *OutOfOrder = true;
+    }
+};
+
+TEST(TreeBuilderTest, ConcurrentRemoval)
+{
+    Component root;
+    std::atomic<bool> out_of_order {false};
+    std::atomic<bool> merging {true};
+    std::thread remover([&root, &merging]{
+        while (merging)
+        {
+            root.RemoveComponent<SampleGuardedComponent>();
+        }
+    });
+
+    TreeBuilder builder;
+    auto& area = builder.CreateStagingArea();
+    for (int round = 0; round < 200; ++round)
+    {
+        area.Stage<SampleGuardedComponent>(&root, &out_of_order);
+        EXPECT_EQ(builder.Merge(), 1u);
+    }
+    merging = false;
+    remover.join();
+    EXPECT_FALSE(out_of_order);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "../GaiaComponents/GaiaComponents.hpp"
+
+using namespace Gaia::Components;
+
+class SampleMotionComponent : public Component
+{
+public:
+    float Position {0.0f};
+    float Velocity {1.0f};
+};
+
+class SampleTickComponent : public Component
+{
+public:
+    int Count {0};
+};
+
+class SampleIdleComponent : public Component
+{};
+
+TEST(UpdateDispatcherTest, GroupedUpdate)
+{
+    Component world;
+    auto* first = world.AddComponent<SampleMotionComponent>();
+    auto* child = first->AddComponent<SampleTickComponent>();
+    auto* idle = world.AddComponent<SampleIdleComponent>();
+    auto* nested = idle->AddComponent<SampleTickComponent>();
+
+    UpdateDispatcher dispatcher;
+    std::vector<std::string> order;
+    dispatcher.Register<SampleTickComponent>([&order](SampleTickComponent& component){
+        ++component.Count;
+        order.emplace_back("Counter");
+    });
+    dispatcher.Register<SampleMotionComponent>([&order](SampleMotionComponent& component){
+        component.Position += component.Velocity;
+        order.emplace_back("Position");
+    });
+    EXPECT_EQ(dispatcher.GetTypeCount(), 2u);
+
+    dispatcher.Dispatch(world);
+    EXPECT_EQ(child->Count, 1);
+    EXPECT_EQ(nested->Count, 1);
+    EXPECT_FLOAT_EQ(first->Position, 1.0f);
+    // Components are updated type by type, in the order of registration.
+    EXPECT_EQ(order, (std::vector<std::string>{"Counter", "Counter", "Position"}));
+
+    dispatcher.Unregister<SampleTickComponent>();
+    dispatcher.Dispatch(world);
+    EXPECT_EQ(child->Count, 1);
+    EXPECT_FLOAT_EQ(first->Position, 2.0f);
+}